@@ -0,0 +1,125 @@
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+
+import ArxConverter.Logger;
+import ArxConverter.ArxExplode;
+
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+
+/// Minimum wall time spent decoding each file, long enough to hide timer noise on tiny props
+constexpr Float64 MinSecondsPerFile = 0.5;
+
+
+struct BenchInput final
+{
+	String             path;
+
+	DynamicArray<Byte> compressed;
+};
+
+
+DynamicArray<Byte> ReadWhole(const fs::path& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+	DynamicArray<Byte> buffer(static_cast<Size>(file.tellg()));
+
+	file.seekg(0, std::ios::beg);
+
+	file.read(reinterpret_cast<Char8*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+	return buffer;
+}
+
+
+DynamicArray<BenchInput> CollectInputs(Int32 argc, CString argv[])
+{
+	DynamicArray<BenchInput> inputs;
+
+	auto add = [&inputs](const fs::path& path)
+	{
+		if (auto data = ReadWhole(path); !data.empty())
+		{
+			inputs.push_back({ path.string(), std::move(data) });
+		}
+	};
+
+	for (Int32 i = 1; i < argc; ++i)
+	{
+		if (const fs::path arg{ argv[i] }; fs::is_directory(arg))
+		{
+			for (const auto& entry : fs::recursive_directory_iterator(arg))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == ".ftl")
+				{
+					add(entry.path());
+				}
+			}
+		}
+		else if (fs::is_regular_file(arg))
+		{
+			add(arg);
+		}
+	}
+
+	return inputs;
+}
+
+
+Int32 main(Int32 argc, CString argv[])
+{
+	Logger logger;
+
+	const auto inputs = CollectInputs(argc, argv);
+
+	if (inputs.empty())
+	{
+		logger.print<LogLevel::Info>("Usage: ArxExplodeBench <file.ftl | directory>...  (e.g. the extracted Exemples/*.zip)");
+
+		return 1;
+	}
+
+
+	Float64 totalSeconds = 0.0;
+
+	Size    totalBytes   = 0ULL;
+
+	for (const auto& [path, compressed] : inputs)
+	{
+		// Warm-up pass, also tells us how many bytes one run produces
+		const Size outSize = ArxExplode(compressed, logger).releaseDecompressed().size();
+
+		Size    runs    = 0ULL;
+
+		Float64 seconds = 0.0;
+
+		const auto start = Clock::now();
+
+		while (seconds < MinSecondsPerFile)
+		{
+			auto out = ArxExplode(compressed, logger).releaseDecompressed();
+
+			++runs;
+
+			seconds = std::chrono::duration<Float64>(Clock::now() - start).count();
+		}
+
+		const Float64 mbPerSecond = static_cast<Float64>(outSize * runs) / seconds / 1.0e6;
+
+		logger.print<LogLevel::Info>("{:>9} -> {:>9} bytes  {:>8.1f} MB/s  ({} runs)  {}", compressed.size(), outSize, mbPerSecond, runs, path);
+
+		totalSeconds += seconds;
+
+		totalBytes   += outSize * runs;
+	}
+
+
+	logger.print<LogLevel::Info>("Total: {:.1f} MB/s of decompressed output over {} file(s)", static_cast<Float64>(totalBytes) / totalSeconds / 1.0e6, inputs.size());
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <span>
+#include <chrono>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+
+import ArxConverter.Logger;
+import ArxConverter.ArxExplode;
+import ArxConverter.ArxImplode;
+
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+
+/// Minimum wall time spent compressing each file at each effort level
+constexpr Float64 MinSecondsPerRun = 0.5;
+
+constexpr Array<UInt32, 3> Efforts = { ArxImplode::MinEffort, ArxImplode::DefaultEffort, ArxImplode::MaxEffort };
+
+/// Every literal coding and dictionary size the format allows, so each table and distance encoding gets a round trip
+constexpr Array<std::pair<ArxImplode::Mode, StringView>, 2> Modes =
+{{
+	{ ArxImplode::Mode::Binary, "binary" },
+	{ ArxImplode::Mode::Ascii,  "ascii"  }
+}};
+
+constexpr Array<std::pair<ArxImplode::Dictionary, StringView>, 3> Dictionaries =
+{{
+	{ ArxImplode::Dictionary::Size1K, "1K" },
+	{ ArxImplode::Dictionary::Size2K, "2K" },
+	{ ArxImplode::Dictionary::Size4K, "4K" }
+}};
+
+/// Odd, small chunk sizes so ArxExplodeStream sees symbols and matches straddling feed and drain boundaries
+constexpr Size StreamFeedChunk  = 7ULL;
+
+constexpr Size StreamDrainChunk = 61ULL;
+
+
+struct BenchInput final
+{
+	String                    path;
+
+	UninitializedArray<Byte> raw;
+};
+
+
+DynamicArray<Byte> ReadWhole(const fs::path& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+	DynamicArray<Byte> buffer(static_cast<Size>(file.tellg()));
+
+	file.seekg(0, std::ios::beg);
+
+	file.read(reinterpret_cast<Char8*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+	return buffer;
+}
+
+
+/// Runs ArxExplodeStream over compressed in StreamFeedChunk pieces, draining StreamDrainChunk bytes at a time.
+/// The output is far larger than the stream's buffer, so its history wrap-around in makeRoom() is exercised too
+DynamicArray<Byte> StreamExplode(std::span<const Byte> compressed, Logger& logger)
+{
+	ArxExplodeStream stream{ logger };
+
+	DynamicArray<Byte> output;
+
+	Array<Byte, StreamDrainChunk> sink;
+
+	Size offset = 0ULL;
+
+	while (!stream.isFinished() || stream.getPendingSize() != 0ULL)
+	{
+		if (stream.getStatus() == ArxExplodeStream::Status::Corrupt)
+		{
+			logger.print<LogLevel::Error>("ArxExplodeStream reported a corrupt or truncated stream");
+		}
+
+
+		if (offset < compressed.size())
+		{
+			offset += stream.feed(compressed.subspan(offset, std::min(StreamFeedChunk, compressed.size() - offset)));
+		}
+		else
+		{
+			stream.finish();
+		}
+
+		const Size drained = stream.drain(sink);
+
+		output.insert(output.end(), sink.begin(), sink.begin() + static_cast<std::ptrdiff_t>(drained));
+	}
+
+	return output;
+}
+
+
+/// Inputs are FTL files, compressed again after exploding them so the bench works on real model data
+DynamicArray<BenchInput> CollectInputs(Int32 argc, CString argv[], Logger& logger)
+{
+	DynamicArray<BenchInput> inputs;
+
+	auto add = [&inputs, &logger](const fs::path& path)
+	{
+		if (const auto data = ReadWhole(path); !data.empty())
+		{
+			inputs.push_back({ path.string(), ArxExplode(data, logger).releaseDecompressed() });
+		}
+	};
+
+	for (Int32 i = 1; i < argc; ++i)
+	{
+		if (const fs::path arg{ argv[i] }; fs::is_directory(arg))
+		{
+			for (const auto& entry : fs::recursive_directory_iterator(arg))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == ".ftl")
+				{
+					add(entry.path());
+				}
+			}
+		}
+		else if (fs::is_regular_file(arg))
+		{
+			add(arg);
+		}
+	}
+
+	return inputs;
+}
+
+
+Int32 main(Int32 argc, CString argv[])
+{
+	Logger logger;
+
+	const auto inputs = CollectInputs(argc, argv, logger);
+
+	if (inputs.empty())
+	{
+		logger.print<LogLevel::Info>("Usage: ArxImplodeBench <file.ftl | directory>...  (e.g. the extracted Exemples/*.zip)");
+
+		return 1;
+	}
+
+
+	for (const auto& [path, raw] : inputs)
+	{
+		for (const auto& [mode, modeName] : Modes)
+		{
+			for (const auto& [dictionary, dictionaryName] : Dictionaries)
+			{
+				for (const UInt32 effort : Efforts)
+				{
+					// Warm-up pass, also checks that ArxExplode gives the input back
+					const auto compressed = ArxImplode(raw, mode, dictionary, effort, logger).releaseCompressed();
+
+					const auto roundTrip  = ArxExplode(compressed, raw.size(), logger).releaseDecompressed();
+
+					if (!std::ranges::equal(roundTrip, raw))
+					{
+						logger.print<LogLevel::Error>("Round trip mismatch ({} {} effort {}): {}", modeName, dictionaryName, effort, path);
+					}
+
+					if (!std::ranges::equal(StreamExplode(compressed, logger), raw))
+					{
+						logger.print<LogLevel::Error>("Streaming round trip mismatch ({} {} effort {}): {}", modeName, dictionaryName, effort, path);
+					}
+
+
+					Size    runs    = 0ULL;
+
+					Float64 seconds = 0.0;
+
+					const auto start = Clock::now();
+
+					while (seconds < MinSecondsPerRun)
+					{
+						auto out = ArxImplode(raw, mode, dictionary, effort, logger).releaseCompressed();
+
+						++runs;
+
+						seconds = std::chrono::duration<Float64>(Clock::now() - start).count();
+					}
+
+					const Float64 mbPerSecond = static_cast<Float64>(raw.size() * runs) / seconds / 1.0e6;
+
+					const Float64 ratio       = static_cast<Float64>(compressed.size()) / static_cast<Float64>(raw.size());
+
+					logger.print<LogLevel::Info>("{:<6} {}  effort {}  {:>9} -> {:>9} bytes  ({:.3f})  {:>7.1f} MB/s  {}", modeName, dictionaryName, effort, raw.size(), compressed.size(), ratio, mbPerSecond, path);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
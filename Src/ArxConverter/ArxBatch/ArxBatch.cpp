@@ -0,0 +1,256 @@
+module;
+
+#include <set>
+#include <span>
+#include <cctype>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+module ArxConverter.ArxBatch;
+
+
+namespace fs = std::filesystem;
+
+
+String LowerExtension(const fs::path& path)
+{
+	String extension = path.extension().string();
+
+	std::ranges::transform(extension, extension.begin(), [](Char8 c) { return static_cast<Char8>(std::tolower(static_cast<UInt8>(c))); });
+
+	return extension;
+}
+
+Bool IsFtlPath(const fs::path& path)
+{
+	return LowerExtension(path) == ".ftl";
+}
+
+Bool IsPakPath(const fs::path& path)
+{
+	return LowerExtension(path) == ".pak";
+}
+
+
+Bool HasWildcard(StringView text)
+{
+	return text.find_first_of("*?") != StringView::npos;
+}
+
+/// '*' matches any run of characters, '?' exactly one; the shell does not expand these on Windows
+Bool MatchWildcard(StringView pattern, StringView name)
+{
+	Size p = 0ULL, n = 0ULL;
+
+	Size starP = StringView::npos, starN = 0ULL;
+
+	while (n < name.size())
+	{
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+		{
+			++p;
+
+			++n;
+		}
+		else if (p < pattern.size() && pattern[p] == '*')
+		{
+			starP = p++;
+
+			starN = n;
+		}
+		else if (starP != StringView::npos)
+		{
+			p = starP + 1ULL;
+
+			n = ++starN;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (p < pattern.size() && pattern[p] == '*')
+	{
+		++p;
+	}
+
+	return p == pattern.size();
+}
+
+
+ArxBatch::ArxBatch(std::span<const String> inputs, const String& manifest, const String& outputDir, Logger& logger) : m_outputDir{ outputDir }, m_logger{ logger }
+{
+	for (const auto& input : inputs)
+	{
+		addInput(input);
+	}
+
+	if (!manifest.empty())
+	{
+		readManifest(manifest);
+	}
+
+
+	if (m_jobs.empty())
+	{
+		m_logger.print<LogLevel::Error>("No .ftl or .pak files found in the given inputs");
+	}
+}
+
+
+std::span<const ArxBatch::Job> ArxBatch::getJobs() const noexcept
+{
+	return m_jobs;
+}
+
+
+Void ArxBatch::addInput(const fs::path& input)
+{
+	if (HasWildcard(input.filename().string()))
+	{
+		addWildcard(input);
+	}
+	else if (fs::is_directory(input))
+	{
+		addDirectory(input);
+	}
+	else if (fs::is_regular_file(input))
+	{
+		addFile(input, m_outputDir.empty() ? input.parent_path() : m_outputDir);
+	}
+	else
+	{
+		m_logger.print<LogLevel::Info>("Skipping missing input: \"{}\"", input.string());
+	}
+}
+
+
+Void ArxBatch::addDirectory(const fs::path& root)
+{
+	DynamicArray<fs::path> found;
+
+	for (const auto& entry : fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied))
+	{
+		if (entry.is_regular_file() && IsFtlPath(entry.path()))
+		{
+			found.push_back(entry.path());
+		}
+	}
+
+	// Directory iteration order is unspecified, sorting keeps runs and logs reproducible
+	std::ranges::sort(found);
+
+
+	for (const auto& file : found)
+	{
+		// With an output directory the tree below root is mirrored there
+		const fs::path outputParent = m_outputDir.empty() ? file.parent_path() : m_outputDir / file.parent_path().lexically_relative(root);
+
+		addFile(file, outputParent);
+	}
+}
+
+
+Void ArxBatch::addWildcard(const fs::path& pattern)
+{
+	const fs::path directory = pattern.has_parent_path() ? pattern.parent_path() : fs::path{ "." };
+
+	if (HasWildcard(directory.string()))
+	{
+		m_logger.print<LogLevel::Info>("Skipping \"{}\": wildcards are only supported in the file name", pattern.string());
+
+		return;
+	}
+
+	if (!fs::is_directory(directory))
+	{
+		m_logger.print<LogLevel::Info>("Skipping missing input: \"{}\"", pattern.string());
+
+		return;
+	}
+
+
+	const String filePattern = pattern.filename().string();
+
+	DynamicArray<fs::path> found;
+
+	for (const auto& entry : fs::directory_iterator(directory))
+	{
+		if (entry.is_regular_file() && MatchWildcard(filePattern, entry.path().filename().string()) && (IsFtlPath(entry.path()) || IsPakPath(entry.path())))
+		{
+			found.push_back(entry.path());
+		}
+	}
+
+	std::ranges::sort(found);
+
+
+	if (found.empty())
+	{
+		m_logger.print<LogLevel::Info>("No match for \"{}\"", pattern.string());
+	}
+
+	for (const auto& file : found)
+	{
+		addFile(file, m_outputDir.empty() ? file.parent_path() : m_outputDir);
+	}
+}
+
+
+Void ArxBatch::addFile(const fs::path& file, const fs::path& outputParent)
+{
+	// Overlapping inputs (a folder and a wildcard inside it) must not convert a model twice
+	if (!m_seenInputs.insert(fs::absolute(file).lexically_normal().string()).second)
+	{
+		return;
+	}
+
+
+	const fs::path outputDir = (outputParent / file.stem()).lexically_normal();
+
+	if (!m_seenOutputs.insert(fs::absolute(outputDir).string()).second)
+	{
+		m_logger.print<LogLevel::Info>("Skipping \"{}\": output directory \"{}\" is already used by another input", file.string(), outputDir.string());
+
+		return;
+	}
+
+
+	m_jobs.push_back({ file.string(), outputDir.string(), IsPakPath(file) });
+}
+
+
+Void ArxBatch::readManifest(const String& manifest)
+{
+	std::ifstream file(manifest);
+
+	if (!file.is_open())
+	{
+		m_logger.print<LogLevel::Error>("Couldn't open manifest: \"{}\"", manifest);
+	}
+
+
+	const fs::path baseDir = fs::path(manifest).parent_path();
+
+	String line;
+
+	while (std::getline(file, line))
+	{
+		// One input per line; blank lines and '#' comments are ignored
+		const auto first = line.find_first_not_of(" \t\r");
+
+		if (first == String::npos || line[first] == '#')
+		{
+			continue;
+		}
+
+		const auto last = line.find_last_not_of(" \t\r");
+
+		const fs::path input{ line.substr(first, last - first + 1ULL) };
+
+
+		addInput(input.is_absolute() ? input : baseDir / input);
+	}
+}
\ No newline at end of file
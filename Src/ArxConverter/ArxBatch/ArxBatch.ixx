@@ -0,0 +1,73 @@
+module;
+
+#include <set>
+#include <span>
+#include <filesystem>
+
+export module ArxConverter.ArxBatch;
+
+
+import ArxConverter.Logger;
+import ArxConverter.Container;
+
+
+/// Extension checks shared by input discovery and archive scanning, case-insensitive like the game's own paths
+export [[nodiscard]] Bool IsFtlPath(const std::filesystem::path& path);
+
+export [[nodiscard]] Bool IsPakPath(const std::filesystem::path& path);
+
+
+/// Expands command line inputs (files, directories, wildcards, manifests) into the list of models to convert
+export class ArxBatch final
+{
+public:
+
+	struct Job final
+	{
+		String inputPath;
+
+		String outputDir;
+
+		Bool   isPak = false;
+	};
+
+private:
+
+	std::filesystem::path m_outputDir; ///< Empty: every model is exported next to its source
+
+
+	Logger& m_logger;
+
+
+	DynamicArray<Job> m_jobs;
+
+	std::set<String>  m_seenInputs;
+
+	std::set<String>  m_seenOutputs;
+
+public:
+
+	ArxBatch() = delete;
+
+   ~ArxBatch() = default;
+
+
+	/// Relative paths in the manifest are resolved against the manifest's own folder
+	explicit ArxBatch(std::span<const String> inputs, const String& manifest, const String& outputDir, Logger& logger);
+
+
+	[[nodiscard]] std::span<const Job> getJobs() const noexcept;
+
+private:
+
+	Void addInput(const std::filesystem::path& input);
+
+	Void addDirectory(const std::filesystem::path& root);
+
+	Void addWildcard(const std::filesystem::path& pattern);
+
+	Void addFile(const std::filesystem::path& file, const std::filesystem::path& outputParent);
+
+
+	Void readManifest(const String& manifest);
+};
\ No newline at end of file
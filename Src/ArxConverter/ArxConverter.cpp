@@ -1,6 +1,16 @@
 module;
 
+#include <span>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <charconv>
+#include <exception>
+#include <algorithm>
+#include <functional>
 #include <filesystem>
+#include <system_error>
 
 module ArxConverter;
 
@@ -8,6 +18,44 @@ module ArxConverter;
 namespace fs = std::filesystem;
 
 
+/// Parses a comma-separated list such as "gltf,obj"; names are case-insensitive
+Bool ParseFormats(StringView list, ExportFormat& formats)
+{
+    formats = ExportFormat::None;
+
+    while (!list.empty())
+    {
+        const Size   comma = list.find(',');
+
+        String       name{ list.substr(0ULL, comma) };
+
+        list = (comma == StringView::npos) ? StringView{} : list.substr(comma + 1ULL);
+
+
+        std::ranges::transform(name, name.begin(), [](Char8 c) { return static_cast<Char8>(std::tolower(static_cast<UInt8>(c))); });
+
+        if      (name == "json") formats = formats | ExportFormat::Json;
+        else if (name == "xml")  formats = formats | ExportFormat::Xml;
+        else if (name == "obj")  formats = formats | ExportFormat::Obj;
+        else if (name == "gltf") formats = formats | ExportFormat::Gltf;
+        else if (name == "all")  formats = formats | ExportFormat::All;
+        else                     return false;
+    }
+
+    return formats != ExportFormat::None;
+}
+
+Bool ParseJsonStyle(StringView name, JsonStyle& style)
+{
+    if      (name == "pretty")  style = JsonStyle::Pretty;
+    else if (name == "compact") style = JsonStyle::Compact;
+    else if (name == "lines")   style = JsonStyle::Lines;
+    else                        return false;
+
+    return true;
+}
+
+
 ArxConverter::ArxConverter(Int32 argc, CString argv[])
 {
     m_logger.clear();
@@ -15,34 +63,148 @@ ArxConverter::ArxConverter(Int32 argc, CString argv[])
     m_logger.print<LogLevel::Info>("ArxConverter starting...");
 
 
-    if (argc != 2 && argc != 3)
+    constexpr StringView usage =
+        "Usage: ArxConverter.exe [--format <json,xml,obj,gltf>] [--json <pretty|compact|lines>] <file.ftl | archive.pak> [output_directory]\n"
+        "       ArxConverter.exe --batch [-o <output_directory>] [--manifest <list.txt>] [--jobs <N>] [--format <json,xml,obj,gltf>] [--json <pretty|compact|lines>] <directory | file | wildcard>...\n"
+        "Options: [--uv-epsilon <value>] [--glb] [--optimize] [--quantize] [--interleave] [--skin]";
+
+    DynamicArray<String> inputs;
+
+    String manifest;
+
+    String outputDir;
+
+    for (Int32 i = 1; i < argc; ++i)
     {
-        m_logger.print<LogLevel::Error>("Usage: ArxConverter.exe <file.ftl> [output_directory]");
+        const StringView arg{ argv[i] };
+
+        if (arg == "--batch")
+        {
+            m_isBatch = true;
+        }
+        else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+        {
+            outputDir = argv[++i];
+        }
+        else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc)
+        {
+            const StringView value{ argv[++i] };
+
+            if (const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), m_jobCount); error != std::errc{} || end != value.data() + value.size())
+            {
+                m_logger.print<LogLevel::Error>("Invalid job count: \"{}\"", value);
+            }
+        }
+        else if ((arg == "-f" || arg == "--format") && i + 1 < argc)
+        {
+            if (const StringView value{ argv[++i] }; !ParseFormats(value, m_exportOptions.formats))
+            {
+                m_logger.print<LogLevel::Error>("Invalid format list: \"{}\" (expected json, xml, obj, gltf or all)", value);
+            }
+        }
+        else if (arg == "--json" && i + 1 < argc)
+        {
+            if (const StringView value{ argv[++i] }; !ParseJsonStyle(value, m_exportOptions.jsonStyle))
+            {
+                m_logger.print<LogLevel::Error>("Invalid JSON style: \"{}\" (expected pretty, compact or lines)", value);
+            }
+        }
+        else if (arg == "--optimize")
+        {
+            m_exportOptions.optimize = true;
+        }
+        else if (arg == "--quantize")
+        {
+            m_exportOptions.quantize = true;
+        }
+        else if (arg == "--interleave")
+        {
+            m_exportOptions.interleave = true;
+        }
+        else if (arg == "--skin")
+        {
+            m_exportOptions.skin = true;
+        }
+        else if (arg == "--glb")
+        {
+            m_exportOptions.gltfBinary = true;
+        }
+        else if (arg == "--uv-epsilon" && i + 1 < argc)
+        {
+            const StringView value{ argv[++i] };
+
+            // 0 means exact matching; anything else must be a finite grid coarse enough for the UV cells to stay meaningful
+            constexpr Float32 MinUvEpsilon = 1e-7f;
+
+            Float32& epsilon = m_exportOptions.uvEpsilon;
+
+            if (const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), epsilon); error != std::errc{} || end != value.data() + value.size() || !std::isfinite(epsilon) || (epsilon != 0.0f && epsilon < MinUvEpsilon))
+            {
+                m_logger.print<LogLevel::Error>("Invalid UV epsilon: \"{}\"", value);
+            }
+        }
+        else if (arg == "--manifest" && i + 1 < argc)
+        {
+            manifest  = argv[++i];
+
+            m_isBatch = true;
+        }
+        else if (arg.starts_with("--"))
+        {
+            m_logger.print<LogLevel::Error>("{}", usage);
+        }
+        else
+        {
+            inputs.emplace_back(arg);
+        }
     }
 
 
-    m_inputPath = argv[1];
+    // A lone directory is a batch too
+    m_isBatch = m_isBatch || (inputs.size() == 1ULL && fs::is_directory(inputs.front()));
 
-    if (!fs::exists(m_inputPath))
+    if (!m_isBatch)
     {
-        m_logger.print<LogLevel::Error>("Input file does not exist: \"{}\"", m_inputPath);
-    }
+        if (inputs.empty() || inputs.size() > 2ULL || (inputs.size() == 2ULL && !outputDir.empty()))
+        {
+            m_logger.print<LogLevel::Error>("{}", usage);
+        }
+
+        if (inputs.size() == 2ULL)
+        {
+            outputDir = inputs.back();
 
+            inputs.pop_back();
+        }
 
-    const fs::path inputPathObj{ m_inputPath };
 
-    const String stemName = inputPathObj.stem().string();
+        m_inputPath = inputs.front();
 
-    if (argc == 3)
+        if (!fs::exists(m_inputPath))
+        {
+            m_logger.print<LogLevel::Error>("Input file does not exist: \"{}\"", m_inputPath);
+        }
+    }
+    else if (inputs.empty() && manifest.empty())
     {
-        m_outputBaseDir = (fs::path(argv[2]) / stemName).string();
+        m_logger.print<LogLevel::Error>("{}", usage);
     }
-    else
+
+
+    m_batch = std::make_unique<ArxBatch>(inputs, manifest, outputDir, m_logger);
+
+    if (m_isBatch)
     {
-        m_outputBaseDir = (inputPathObj.parent_path() / stemName).string();
+        m_logger.print<LogLevel::Info>("Batch:       {} input file(s)", m_batch->getJobs().size());
+
+        m_logger.print<LogLevel::Info>("Output dir:  \"{}\"", outputDir.empty() ? "next to each input" : outputDir);
+
+        return;
     }
 
 
+    m_outputBaseDir = m_batch->getJobs().front().outputDir;
+
     if (!fs::exists(m_outputBaseDir))
     {
         try
@@ -64,22 +226,218 @@ ArxConverter::ArxConverter(Int32 argc, CString argv[])
 
 Void ArxConverter::start()
 {
-    m_logger.print<LogLevel::Info>("Reading and Decompressing...");
+    const auto begin = std::chrono::steady_clock::now();
+
+    planTasks();
+
+
+    WorkStealingPool pool{ m_jobCount };
+
+    m_workerCount = pool.getWorkerCount();
+
+
+    // A single model keeps failing loudly, the way the converter always did
+    if (!m_isBatch && m_paks.empty())
+    {
+        Worker worker;
+
+        convertTask(m_tasks.front(), worker);
 
-    m_file = std::make_unique<ArxFile>(m_inputPath, m_logger);
+        m_logger.print<LogLevel::Info>("Done.");
+
+        return;
+    }
 
 
-    m_logger.print<LogLevel::Info>("Parsing Data...");
+    DynamicArray<Worker>  workers(pool.getWorkerCount());
 
-    m_parser = std::make_unique<ArxParser>(m_file->getDecompressed(), m_logger);
+    DynamicArray<Failure> outcomes(m_tasks.size()); ///< One slot per task, an empty message means success
 
+    m_logger.print<LogLevel::Info>("Converting {} model(s) on {} thread(s)", m_tasks.size(), std::min(pool.getWorkerCount(), m_tasks.size()));
 
-    m_logger.print<LogLevel::Info>("Exporting...");
 
-    m_exporter = std::make_unique<ArxExporter>(m_parser->getHeaders(), m_parser->getData(),m_outputBaseDir, m_logger);
+    pool.run(m_tasks.size(), [&](Index taskIndex, Index workerIndex)
+    {
+        const auto& task = m_tasks[taskIndex];
 
+        m_logger.print<LogLevel::Info>("[{}/{}] \"{}\"", ++m_startedTasks, m_tasks.size(), task.inputPath);
 
-    m_exporter->exportAll();
+        try
+        {
+            convertTask(task, workers[workerIndex]);
+        }
+        catch (const std::exception& error)
+        {
+            outcomes[taskIndex] = { task.inputPath, error.what() };
+        }
+        catch (...)
+        {
+            outcomes[taskIndex] = { task.inputPath, "Unknown error" };
+        }
+    });
+
+
+    Size converted = 0ULL;
+
+    for (auto& outcome : outcomes)
+    {
+        if (outcome.message.empty())
+        {
+            ++converted;
+        }
+        else
+        {
+            m_failures.push_back(std::move(outcome));
+        }
+    }
+
+
+    const Float64 seconds = std::chrono::duration<Float64>(std::chrono::steady_clock::now() - begin).count();
+
+    m_logger.print<LogLevel::Info>("Summary: {} model(s) converted, {} failed, {:.2f} s", converted, m_failures.size(), seconds);
+
+    for (const auto& [path, message] : m_failures)
+    {
+        m_logger.print<LogLevel::Info>("  Failed \"{}\": {}", path, message);
+    }
+
+    if (!m_failures.empty())
+    {
+        m_logger.print<LogLevel::Error>("{} model(s) could not be converted", m_failures.size());
+    }
 
     m_logger.print<LogLevel::Info>("Done.");
+}
+
+
+Void ArxConverter::planTasks()
+{
+    for (const auto& job : m_batch->getJobs())
+    {
+        if (!job.isPak)
+        {
+            std::error_code error;
+
+            const auto size = fs::file_size(job.inputPath, error);
+
+            m_tasks.push_back({ job.inputPath, job.outputDir, nullptr, nullptr, error ? 0ULL : static_cast<Size>(size) });
+
+            continue;
+        }
+
+
+        m_logger.print<LogLevel::Info>("Reading archive directory of \"{}\"...", job.inputPath);
+
+        try
+        {
+            m_paks.push_back(std::make_unique<ArxPak>(job.inputPath, m_logger));
+        }
+        catch (const std::exception& error)
+        {
+            if (!m_isBatch)
+            {
+                throw;
+            }
+
+            m_failures.push_back({ job.inputPath, error.what() });
+
+            continue;
+        }
+
+
+        const ArxPak& pak = *m_paks.back();
+
+        Size models = 0ULL;
+
+        for (const auto& entry : pak.getEntries())
+        {
+            if (!IsFtlPath(entry.path))
+            {
+                continue;
+            }
+
+
+            // Archive paths are untrusted, keep every model below the output directory
+            const fs::path relative = fs::path(entry.path).lexically_normal().relative_path();
+
+            if (relative.empty() || *relative.begin() == "..")
+            {
+                m_logger.print<LogLevel::Info>("Skipping entry outside the archive root: \"{}\"", entry.path);
+
+                continue;
+            }
+
+            fs::path outputDir = fs::path(job.outputDir) / relative;
+
+            outputDir.replace_extension();
+
+
+            m_tasks.push_back({ job.inputPath + ":" + entry.path, outputDir.string(), &pak, &entry, entry.size });
+
+            ++models;
+        }
+
+        m_logger.print<LogLevel::Info>("Found {} model(s) in {} entries", models, pak.getEntries().size());
+    }
+
+
+    // Longest-first keeps a big model from starting last and stretching the run on its own
+    std::ranges::stable_sort(m_tasks, std::ranges::greater{}, &Task::cost);
+}
+
+
+Void ArxConverter::convertTask(const Task& task, Worker& worker)
+{
+    if (task.pak == nullptr)
+    {
+        m_logger.print<LogLevel::Info>("Reading and Decompressing \"{}\"...", task.inputPath);
+
+        ArxFile file(task.inputPath, std::move(worker.buffer), m_logger);
+
+        convert(file.getDecompressed(), task);
+
+        worker.buffer = file.releaseDecompressed();
+
+        return;
+    }
+
+
+    // FTL files are imploded themselves; stored entries go from the mapping into ArxExplode without a copy
+    UninitializedArray<Byte> unpacked;
+
+    std::span<const Byte> ftl = task.pak->getStored(*task.entry);
+
+    if (task.entry->compressed)
+    {
+        unpacked = task.pak->extract(*task.entry);
+
+        ftl      = unpacked;
+    }
+
+    auto decompressed = ArxExplode(ftl, std::move(worker.buffer), m_logger).releaseDecompressed();
+
+    convert(decompressed, task);
+
+    worker.buffer = std::move(decompressed);
+}
+
+
+Void ArxConverter::convert(std::span<const Byte> decompressed, const Task& task)
+{
+    // Batch workers interleave their lines, the path tells which model each one belongs to
+    m_logger.print<LogLevel::Info>("Parsing \"{}\"...", task.inputPath);
+
+    const ArxParser parser(decompressed, m_logger);
+
+
+    m_logger.print<LogLevel::Info>("Exporting \"{}\"...", task.inputPath);
+
+    ArxExporter exporter(parser.getHeaders(), parser.getData(), task.outputDir, m_exportOptions, m_logger);
+
+
+    // Once fewer models are queued than there are workers (a small batch, or the tail of a big one), the idle
+    // cores go to running this model's writers concurrently; a full batch keeps one model per core
+    const Bool parallel = m_tasks.size() - m_startedTasks.load(std::memory_order_relaxed) < m_workerCount;
+
+    exporter.exportAll(parallel);
 }
\ No newline at end of file
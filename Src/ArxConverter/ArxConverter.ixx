@@ -1,12 +1,23 @@
 module;
 
+#include <span>
+#include <atomic>
+
 export module ArxConverter;
 
 
 export import ArxConverter.Logger;
 
+	   import ArxConverter.ArxPak;
+
+	   import ArxConverter.ArxBatch;
+
+	   import ArxConverter.ArxExplode;
+
 	   import ArxConverter.ArxFile;
 
+	   import ArxConverter.WorkStealingPool;
+
        import ArxConverter.ArxParser;
 
        import ArxConverter.ArxExporter;
@@ -14,6 +25,36 @@ export import ArxConverter.Logger;
 
 export class ArxConverter final
 {
+    /// One model to convert: a loose file, or an .ftl entry of an opened archive
+    struct Task final
+    {
+        String inputPath;
+
+        String outputDir;
+
+
+        const ArxPak*        pak   = nullptr;
+
+        const ArxPak::Entry* entry = nullptr;
+
+
+        Size cost = 0ULL; ///< Compressed size, biggest models are scheduled first
+    };
+
+    struct Failure final
+    {
+        String path;
+
+        String message;
+    };
+
+    /// Scratch state owned by one worker thread and reused from one model to the next
+    struct Worker final
+    {
+        UninitializedArray<Byte> buffer;
+    };
+
+
     Logger m_logger;
 
 
@@ -21,12 +62,24 @@ export class ArxConverter final
 
     String m_outputBaseDir;
 
+    Bool   m_isBatch  = false;
+
+    Size   m_jobCount = 0ULL; ///< --jobs, 0 means one per hardware thread
+
+    ExportOptions m_exportOptions;
+
+    Size   m_workerCount = 0ULL;
+
+    std::atomic<Size> m_startedTasks{ 0ULL }; ///< Tasks handed to a worker so far; fewer queued than workers means idle cores
 
-	Unique<ArxFile>     m_file;
 
-	Unique<ArxParser>   m_parser;
+	Unique<ArxBatch>             m_batch;
 
-	Unique<ArxExporter> m_exporter;
+	DynamicArray<Unique<ArxPak>> m_paks;
+
+	DynamicArray<Task>           m_tasks;
+
+	DynamicArray<Failure>        m_failures;
 
 public:
 
@@ -39,4 +92,14 @@ public:
 
 
     Void start();
+
+private:
+
+    /// Opens archives and expands every job into per-model tasks, ordered by cost
+    Void planTasks();
+
+    /// Safe to call from several workers at once as long as each passes its own Worker
+    Void convertTask(const Task& task, Worker& worker);
+
+    Void convert(std::span<const Byte> decompressed, const Task& task);
 };
\ No newline at end of file
@@ -1,445 +1,597 @@
 module;
 
 #include <map>
+#include <span>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <mutex>
 #include <array>
+#include <future>
+#include <utility>
 #include <vector>
+#include <unordered_map>
 #include <numeric>
+#include <optional>
 #include <clocale>
 #include <fstream>
 #include <algorithm>
 #include <filesystem>
 
+#include "fmt/compile.h"
 #include "nlohmann/json.hpp"
-#include "tinyxml2.h"
 
 module ArxConverter.ArxExporter;
 
+import ArxConverter.JsonWriter;
+import ArxConverter.XmlWriter;
+import ArxConverter.RenderMesh;
+
 namespace fs = std::filesystem;
 using json   = nlohmann::json;
 
-using namespace tinyxml2;
-
-ArxExporter::ArxExporter(const FtlHeaders& headers, const FtlFileData& data, const String& outputDir, Logger& logger) noexcept : m_headers{ headers }, m_data{ data }, m_baseOutputDirectory{ outputDir }, m_logger{ logger }
+ArxExporter::ArxExporter(const FtlHeaders& headers, const FtlFileData& data, const String& outputDir, const ExportOptions& options, Logger& logger) noexcept : m_headers{ headers }, m_data{ data }, m_baseOutputDirectory{ outputDir }, m_options{ options }, m_logger{ logger }
 {
 
 }
 
-Void ArxExporter::exportAll()
+Void ArxExporter::exportAll(Bool parallel)
 {
-    std::setlocale(LC_NUMERIC, "C");
+    // setlocale is process-wide and not thread-safe, batch workers must not race on it
+    static std::once_flag localeFlag;
+
+    std::call_once(localeFlag, [] { std::setlocale(LC_NUMERIC, "C"); });
 
     createDirectories();
 
-    m_logger.print<LogLevel::Info>("Exporting JSON...");
-    exportJson();
 
-    m_logger.print<LogLevel::Info>("Exporting XML...");
-    exportXml();
+    using Writer = Void (ArxExporter::*)() const;
+
+    struct WriterEntry final
+    {
+        ExportFormat format;
+
+        StringView   label;
+
+        Writer       writer;
+    };
+
+    constexpr Array<WriterEntry, 4> writers =
+    {{
+        { ExportFormat::Json, "Exporting JSON",     &ArxExporter::exportJson   },
+        { ExportFormat::Xml,  "Exporting XML",      &ArxExporter::exportXml    },
+        { ExportFormat::Obj,  "Exporting OBJ/MTL",  &ArxExporter::exportObjMtl },
+        { ExportFormat::Gltf, "Exporting GLTF 2.0", &ArxExporter::exportGltf   }
+    }};
+
+    if (!parallel)
+    {
+        for (const auto& [format, label, writer] : writers)
+        {
+            if (HasFormat(m_options.formats, format))
+            {
+                m_logger.print<LogLevel::Info>("{} to \"{}\"...", label, m_baseOutputDirectory);
+                (this->*writer)();
+            }
+        }
+
+        return;
+    }
+
+
+    // Every writer only reads m_headers/m_data and owns its output files
+    DynamicArray<std::future<Void>> pending;
 
-    m_logger.print<LogLevel::Info>("Exporting OBJ/MTL...");
-    exportObjMtl();
+    for (const auto& [format, label, writer] : writers)
+    {
+        if (HasFormat(m_options.formats, format))
+        {
+            m_logger.print<LogLevel::Info>("{} to \"{}\"...", label, m_baseOutputDirectory);
+            pending.push_back(std::async(std::launch::async, writer, this));
+        }
+    }
 
-    m_logger.print<LogLevel::Info>("Exporting GLTF 2.0...");
-    exportGltf();
+    // Waited on in order, so the first failing writer (in serial order) is the one reported
+    for (auto& writer : pending)
+    {
+        writer.get();
+    }
 }
 
 Void ArxExporter::createDirectories() const
 {
     const fs::path base{ m_baseOutputDirectory };
 
-    fs::create_directories(base / "RAW" / "JSON");
-    fs::create_directories(base / "RAW" / "XML");
-    fs::create_directories(base / "OBJ");
-    fs::create_directories(base / "GLTF");
+    if (HasFormat(m_options.formats, ExportFormat::Json))
+    {
+        fs::create_directories(base / "RAW" / "JSON");
+    }
+
+    if (HasFormat(m_options.formats, ExportFormat::Xml))
+    {
+        fs::create_directories(base / "RAW" / "XML");
+    }
+
+    if (HasFormat(m_options.formats, ExportFormat::Obj))
+    {
+        fs::create_directories(base / "OBJ");
+    }
+
+    if (HasFormat(m_options.formats, ExportFormat::Gltf))
+    {
+        fs::create_directories(base / "GLTF");
+    }
 }
 
-Void ArxExporter::exportJson() const
+// Record writers shared by Data.json and the JSON Lines files. Keys go out in sorted order, like the
+// std::map backed nlohmann objects they replace, so pretty output stays byte-identical
+Void WriteVec3(JsonWriter& json, StringView name, const Vector3D& v)
 {
-    const fs::path jsonDir = fs::path(m_baseOutputDirectory) / "RAW" / "JSON";
+    json.field(name, Array<Float32, 3>{ v.x, v.y, v.z });
+}
 
-	constexpr Size bufSize = 64 * 1024;
+Void WriteAction(JsonWriter& json, const ActionPoint& action)
+{
+    json.beginObject();
+    json.field("flags",   action.actionTypeFlags);
+    json.field("name",    StringView(action.actionName.data()));
+    json.field("soundId", action.soundEffectId);
+    json.field("vertex",  action.vertexIndex);
+    json.endObject();
+}
 
-    DynamicArray<Char8> buffer(bufSize);
+Void WriteClothSpring(JsonWriter& json, const ClothSpring& spring)
+{
+    json.beginObject();
+    json.field("damping",    spring.damping);
+    json.field("restLength", spring.restLength);
+    json.field("stiffness",  spring.stiffness);
+    json.field("type",       spring.springType);
+    json.field("v1",         spring.startVertexIndex);
+    json.field("v2",         spring.endVertexIndex);
+    json.endObject();
+}
 
+Void WriteClothVertex(JsonWriter& json, const ClothVertex& cv)
+{
+    json.beginObject();
+    json.field("collision", cv.collisionEnabled);
+    json.field("flags",     cv.behaviorFlags);
+    json.field("mass",      cv.mass);
+    json.field("meshIndex", cv.meshVertexIndex);
+    WriteVec3(json, "pos", cv.position);
+    json.endObject();
+}
+
+Void WriteFace(JsonWriter& json, const MeshFace& f)
+{
+    json.beginObject();
+    WriteVec3(json, "faceNormal", f.faceNormal);
+    json.field("flags",   f.faceTypeFlags);
+    json.field("indices", f.vertexIndices);
+
+    json.key("texCoords");
+    json.beginObject();
+    json.field("u", f.textureU);
+    json.field("v", f.textureV);
+    json.endObject();
+
+    json.field("texIndices",   f.textureIndex);
+    json.field("transparency", f.transparency);
+    json.field("vertexColors", f.vertexColors);
+    json.endObject();
+}
+
+/// Groups and selections without an index list (truncated files) simply omit "vertexIndices"
+Void WriteGroup(JsonWriter& json, const VertexGroup& g, const DynamicArray<Int32>* vertexIndices)
+{
+    json.beginObject();
+    json.field("name",         StringView(g.groupName.data()));
+    json.field("originVertex", g.originVertexIndex);
+    json.field("radius",       g.boundingRadius);
+
+    if (vertexIndices != nullptr)
     {
-        std::ofstream file(jsonDir / "Headers.json");
+        json.field("vertexIndices", *vertexIndices);
+    }
+
+    json.endObject();
+}
 
-        file.rdbuf()->pubsetbuf(buffer.data(), bufSize);
+Void WriteSelection(JsonWriter& json, const VertexSelection& selection, const DynamicArray<Int32>* vertexIndices)
+{
+    json.beginObject();
+    json.field("name", StringView(selection.selectionName.data()));
 
-        json jHead;
+    if (vertexIndices != nullptr)
+    {
+        json.field("vertexIndices", *vertexIndices);
+    }
 
-        jHead["primary"] =
-        {
-            { "identifier", String(m_headers.primary.identifier.data(), 3) },
-            { "version",    m_headers.primary.version }
-        };
+    json.endObject();
+}
 
-        jHead["secondary_offsets"] =
-        {
-            { "3dData",           m_headers.secondary.offset3dData },
-            { "clothesData",      m_headers.secondary.offsetClothesData },
-            { "collisionSpheres", m_headers.secondary.offsetCollisionSpheres },
-            { "progressiveData",  m_headers.secondary.offsetProgressiveData },
-            { "cylinder",         m_headers.secondary.offsetCylinder },
-            { "physicsBox",       m_headers.secondary.offsetPhysicsBox }
-        };
+Void WriteVertex(JsonWriter& json, const MeshVertex& vertex)
+{
+    const auto& [legacyVertex, position, normal] = vertex;
+
+    json.beginObject();
+
+    json.key("legacy");
+    json.beginObject();
+    json.field("color",    legacyVertex.color);
+    json.field("rhw",      legacyVertex.rhw);
+    json.field("screen",   Array<Float32, 3>{ legacyVertex.screenX, legacyVertex.screenY, legacyVertex.screenZ });
+    json.field("specular", legacyVertex.specular);
+    json.field("uv",       Array<Float32, 2>{ legacyVertex.textureU, legacyVertex.textureV });
+    json.endObject();
+
+    WriteVec3(json, "normal",   normal);
+    WriteVec3(json, "position", position);
+    json.endObject();
+}
 
-        jHead["section_headers"] =
-        {
-            { "3dData", {
-                { "vertexCount",       m_headers.data3D.vertexCount },
-                { "faceCount",         m_headers.data3D.faceCount },
-                { "textureCount",      m_headers.data3D.textureCount },
-                { "groupCount",        m_headers.data3D.groupCount },
-                { "actionCount",       m_headers.data3D.actionCount },
-                { "selectionCount",    m_headers.data3D.selectionCount },
-                { "originVertexIndex", m_headers.data3D.originVertexIndex },
-                { "modelName",         String(m_headers.data3D.modelName.data()) }
-            }},
-            {
-            	"clothes",
-			{
-                { "vertexCount", m_headers.clothesData.clothVertexCount },
-                { "springCount", m_headers.clothesData.springCount }
-            }},
-            { "progressive",
-            {
-                { "vertexCount", m_headers.progressiveData.vertexCount }
-            }},
-            { "collisionSpheres",
-            {
-                { "count", m_headers.collisionSpheresData.sphereCount }
-            }}
-        };
+const DynamicArray<Int32>* IndicesAt(const DynamicArray<DynamicArray<Int32>>& lists, Index i)
+{
+    return (i < lists.size()) ? &lists[i] : nullptr;
+}
+
+
+Void ArxExporter::exportJson() const
+{
+    const fs::path jsonDir = fs::path(m_baseOutputDirectory) / "RAW" / "JSON";
+
+    const Int32    indent  = (m_options.jsonStyle == JsonStyle::Pretty) ? 4 : -1;
 
-        file << jHead.dump(4);
+    {
+        std::ofstream file(jsonDir / "Headers.json");
+
+        JsonWriter json(file, indent);
+
+        json.beginObject();
+
+        json.key("primary");
+        json.beginObject();
+        json.field("identifier", StringView(m_headers.primary.identifier.data(), 3));
+        json.field("version",    m_headers.primary.version);
+        json.endObject();
+
+        json.key("secondary_offsets");
+        json.beginObject();
+        json.field("3dData",           m_headers.secondary.offset3dData);
+        json.field("clothesData",      m_headers.secondary.offsetClothesData);
+        json.field("collisionSpheres", m_headers.secondary.offsetCollisionSpheres);
+        json.field("cylinder",         m_headers.secondary.offsetCylinder);
+        json.field("physicsBox",       m_headers.secondary.offsetPhysicsBox);
+        json.field("progressiveData",  m_headers.secondary.offsetProgressiveData);
+        json.endObject();
+
+        json.key("section_headers");
+        json.beginObject();
+
+        json.key("3dData");
+        json.beginObject();
+        json.field("actionCount",       m_headers.data3D.actionCount);
+        json.field("faceCount",         m_headers.data3D.faceCount);
+        json.field("groupCount",        m_headers.data3D.groupCount);
+        json.field("modelName",         StringView(m_headers.data3D.modelName.data()));
+        json.field("originVertexIndex", m_headers.data3D.originVertexIndex);
+        json.field("selectionCount",    m_headers.data3D.selectionCount);
+        json.field("textureCount",      m_headers.data3D.textureCount);
+        json.field("vertexCount",       m_headers.data3D.vertexCount);
+        json.endObject();
+
+        json.key("clothes");
+        json.beginObject();
+        json.field("springCount", m_headers.clothesData.springCount);
+        json.field("vertexCount", m_headers.clothesData.clothVertexCount);
+        json.endObject();
+
+        json.key("collisionSpheres");
+        json.beginObject();
+        json.field("count", m_headers.collisionSpheresData.sphereCount);
+        json.endObject();
+
+        json.key("progressive");
+        json.beginObject();
+        json.field("vertexCount", m_headers.progressiveData.vertexCount);
+        json.endObject();
+
+        json.endObject();
+
+        json.endObject();
+    }
+
+    if (m_options.jsonStyle == JsonStyle::Lines)
+    {
+        exportJsonLines();
+
+        return;
     }
 
     {
         std::ofstream file(jsonDir / "Data.json");
 
-        file.rdbuf()->pubsetbuf(buffer.data(), bufSize);
+        JsonWriter json(file, indent);
 
-        json jData;
+        json.beginObject();
 
-        DynamicArray<json> jVertices;
 
-        jVertices.reserve(m_data.vertices.size());
+        json.key("actions");
+        json.beginArray();
 
-        for (const auto& [legacyVertex, position, normal] : m_data.vertices)
+        for (const auto& action : m_data.actionPoints)
         {
-            jVertices.push_back(
-            {
-                { "position", { position.x, position.y, position.z } },
-                { "normal",   { normal.x, normal.y, normal.z } },
-                { "legacy",
-                {
-                    { "screen", { legacyVertex.screenX, legacyVertex.screenY, legacyVertex.screenZ } },
-                    { "rhw", legacyVertex.rhw },
-                    { "color", legacyVertex.color },
-                    { "specular", legacyVertex.specular },
-                    { "uv", { legacyVertex.textureU, legacyVertex.textureV } }
-                }}
-            });
+            WriteAction(json, action);
         }
 
-        jData["vertices"] = std::move(jVertices);
+        json.endArray();
 
-        DynamicArray<json> jFaces;
 
-        jFaces.reserve(m_data.faces.size());
+        json.key("cloth");
+        json.beginObject();
 
-        for (const auto& f : m_data.faces)
+        json.key("springs");
+        json.beginArray();
+
+        for (const auto& spring : m_data.clothSprings)
         {
-            jFaces.push_back(
-            {
-                { "indices", f.vertexIndices },
-                { "texIndices", f.textureIndex },
-                { "flags", f.faceTypeFlags },
-                { "transparency", f.transparency },
-                { "texCoords",
-                {
-                    { "u", f.textureU },
-                    { "v", f.textureV }
-                }},
-                { "vertexColors", f.vertexColors },
-                { "faceNormal", { f.faceNormal.x, f.faceNormal.y, f.faceNormal.z } }
-            });
+            WriteClothSpring(json, spring);
         }
-        jData["faces"] = std::move(jFaces);
-
 
-        DynamicArray<json> jGroups;
+        json.endArray();
 
-        jGroups.reserve(m_data.vertexGroups.size());
+        json.key("vertices");
+        json.beginArray();
 
-        for (Index i = 0; i < m_data.vertexGroups.size(); ++i)
+        for (const auto& cv : m_data.clothVertices)
         {
-            const auto& g = m_data.vertexGroups[i];
+            WriteClothVertex(json, cv);
+        }
 
-            json gJson;
+        json.endArray();
 
-            gJson["name"] = String(g.groupName.data());
-            gJson["originVertex"] = g.originVertexIndex;
-            gJson["radius"] = g.boundingRadius;
+        json.endObject();
 
-            if (i < m_data.groupVertexIndices.size())
-            {
-                gJson["vertexIndices"] = m_data.groupVertexIndices[i];
-            }
 
-            jGroups.push_back(std::move(gJson));
+        json.key("faces");
+        json.beginArray();
+
+        for (const auto& f : m_data.faces)
+        {
+            WriteFace(json, f);
         }
 
-        jData["groups"] = std::move(jGroups);
+        json.endArray();
 
-        DynamicArray<json> jActions;
 
-        jActions.reserve(m_data.actionPoints.size());
+        json.key("groups");
+        json.beginArray();
 
-        for (const auto& [actionName, vertexIndex, actionTypeFlags, soundEffectId] : m_data.actionPoints)
+        for (Index i = 0; i < m_data.vertexGroups.size(); ++i)
         {
-            jActions.push_back(
-			{
-                { "name", String(actionName.data()) },
-                { "vertex", vertexIndex },
-                { "flags", actionTypeFlags },
-                { "soundId", soundEffectId }
-            });
+            WriteGroup(json, m_data.vertexGroups[i], IndicesAt(m_data.groupVertexIndices, i));
         }
-        jData["actions"] = std::move(jActions);
 
-        DynamicArray<json> jSelections;
+        json.endArray();
+
 
-        jSelections.reserve(m_data.vertexSelections.size());
+        json.key("selections");
+        json.beginArray();
 
-        for (Size i = 0; i < m_data.vertexSelections.size(); ++i)
+        for (Index i = 0; i < m_data.vertexSelections.size(); ++i)
         {
-            const auto& sel = m_data.vertexSelections[i];
+            WriteSelection(json, m_data.vertexSelections[i], IndicesAt(m_data.selectionVertexIndices, i));
+        }
 
-            json sJson;
+        json.endArray();
 
-            sJson["name"] = String(sel.selectionName.data());
 
-            if (i < m_data.selectionVertexIndices.size())
-            {
-                sJson["vertexIndices"] = m_data.selectionVertexIndices[i];
-            }
+        json.field("textures", m_data.texturePaths);
 
-            jSelections.push_back(std::move(sJson));
+
+        json.key("vertices");
+        json.beginArray();
+
+        for (const auto& vertex : m_data.vertices)
+        {
+            WriteVertex(json, vertex);
         }
 
-        jData["selections"] = std::move(jSelections);
-        jData["textures"] = m_data.texturePaths;
+        json.endArray();
+
+
+        json.endObject();
+    }
+}
 
-        json jCloth;
+Void ArxExporter::exportJsonLines() const
+{
+    const fs::path jsonDir = fs::path(m_baseOutputDirectory) / "RAW" / "JSON";
 
-        DynamicArray<json> jClothVerts;
+    // Each file holds one kind of record, so readers can stream it line by line in constant memory
+    auto writeLines = [&jsonDir](StringView fileName, Size count, const auto& writeRecord)
+    {
+        std::ofstream file(jsonDir / fileName);
 
-        jClothVerts.reserve(m_data.clothVertices.size());
+        JsonWriter json(file, -1);
 
-        for (const auto& cv : m_data.clothVertices)
+        for (Index i = 0; i < count; ++i)
         {
-            jClothVerts.push_back(
-            {
-                { "meshIndex", cv.meshVertexIndex },
-                { "pos", { cv.position.x, cv.position.y, cv.position.z } },
-                { "mass", cv.mass },
-                { "flags", cv.behaviorFlags },
-                { "collision", cv.collisionEnabled }
-            });
+            writeRecord(json, i);
+
+            json.endRecord();
         }
+    };
 
-        jCloth["vertices"] = std::move(jClothVerts);
+    writeLines("Vertices.jsonl", m_data.vertices.size(), [this](JsonWriter& json, Index i) { WriteVertex(json, m_data.vertices[i]); });
 
-        DynamicArray<json> jClothSprings;
+    writeLines("Faces.jsonl", m_data.faces.size(), [this](JsonWriter& json, Index i) { WriteFace(json, m_data.faces[i]); });
 
-        jClothSprings.reserve(m_data.clothSprings.size());
+    writeLines("Groups.jsonl", m_data.vertexGroups.size(), [this](JsonWriter& json, Index i)
+    {
+        WriteGroup(json, m_data.vertexGroups[i], IndicesAt(m_data.groupVertexIndices, i));
+    });
 
-        for (const auto& [startVertexIndex, endVertexIndex, restLength, stiffness, damping, springType] : m_data.clothSprings)
-        {
-            jClothSprings.push_back(
-            {
-                { "v1", startVertexIndex },
-                { "v2", endVertexIndex },
-                { "restLength", restLength },
-                { "stiffness", stiffness },
-                { "damping", damping },
-                { "type", springType }
-            });
-        }
+    writeLines("Actions.jsonl", m_data.actionPoints.size(), [this](JsonWriter& json, Index i) { WriteAction(json, m_data.actionPoints[i]); });
 
-        jCloth["springs"] = std::move(jClothSprings);
-        jData["cloth"] = std::move(jCloth);
+    writeLines("Selections.jsonl", m_data.vertexSelections.size(), [this](JsonWriter& json, Index i)
+    {
+        WriteSelection(json, m_data.vertexSelections[i], IndicesAt(m_data.selectionVertexIndices, i));
+    });
 
-        file << jData.dump(4);
-    }
+    writeLines("Textures.jsonl", m_data.texturePaths.size(), [this](JsonWriter& json, Index i) { json.value(m_data.texturePaths[i]); });
+
+    writeLines("ClothVertices.jsonl", m_data.clothVertices.size(), [this](JsonWriter& json, Index i) { WriteClothVertex(json, m_data.clothVertices[i]); });
+
+    writeLines("ClothSprings.jsonl", m_data.clothSprings.size(), [this](JsonWriter& json, Index i) { WriteClothSpring(json, m_data.clothSprings[i]); });
 }
 
 Void ArxExporter::exportXml() const
 {
     const fs::path xmlDir = fs::path(m_baseOutputDirectory) / "RAW" / "XML";
 
-    auto setVec3 = [](XMLElement* el, const char* name, const Vector3D& v)
-	{
-        Char8 buf[64];
-
-        std::snprintf(buf, sizeof(buf), "%s_x", name); el->SetAttribute(buf, v.x);
-        std::snprintf(buf, sizeof(buf), "%s_y", name); el->SetAttribute(buf, v.y);
-        std::snprintf(buf, sizeof(buf), "%s_z", name); el->SetAttribute(buf, v.z);
+    auto setVec3 = [](XmlWriter& xml, StringView x, StringView y, StringView z, const Vector3D& v)
+    {
+        xml.attribute(x, v.x);
+        xml.attribute(y, v.y);
+        xml.attribute(z, v.z);
     };
 
     {
-        XMLDocument docHead;
-
-        XMLElement* rootHead = docHead.NewElement("FtlHeaders");
-
-        docHead.InsertEndChild(rootHead);
-
+        std::ofstream file(xmlDir / "Headers.xml");
 
-        XMLElement* prim = docHead.NewElement("Primary");
+        XmlWriter xml(file);
 
-        prim->SetAttribute("ID", String(m_headers.primary.identifier.data(), 3).c_str());
-        prim->SetAttribute("Ver", m_headers.primary.version);
-        rootHead->InsertEndChild(prim);
+        xml.openElement("FtlHeaders");
 
 
-        XMLElement* sec = docHead.NewElement("Offsets");
+        xml.openElement("Primary");
+        xml.attribute("ID", StringView(m_headers.primary.identifier.data(), 3));
+        xml.attribute("Ver", m_headers.primary.version);
+        xml.closeElement();
 
-        sec->SetAttribute("Data3D", m_headers.secondary.offset3dData);
-        sec->SetAttribute("Clothes", m_headers.secondary.offsetClothesData);
-        sec->SetAttribute("Collision", m_headers.secondary.offsetCollisionSpheres);
-        sec->SetAttribute("Progressive", m_headers.secondary.offsetProgressiveData);
-        rootHead->InsertEndChild(sec);
 
+        xml.openElement("Offsets");
+        xml.attribute("Data3D", m_headers.secondary.offset3dData);
+        xml.attribute("Clothes", m_headers.secondary.offsetClothesData);
+        xml.attribute("Collision", m_headers.secondary.offsetCollisionSpheres);
+        xml.attribute("Progressive", m_headers.secondary.offsetProgressiveData);
+        xml.closeElement();
 
-        XMLElement* h3d = docHead.NewElement("Header3D");
 
-        h3d->SetAttribute("Vertices", m_headers.data3D.vertexCount);
-        h3d->SetAttribute("Faces", m_headers.data3D.faceCount);
-        h3d->SetAttribute("Groups", m_headers.data3D.groupCount);
-        h3d->SetAttribute("ModelName", m_headers.data3D.modelName.data());
-        rootHead->InsertEndChild(h3d);
+        xml.openElement("Header3D");
+        xml.attribute("Vertices", m_headers.data3D.vertexCount);
+        xml.attribute("Faces", m_headers.data3D.faceCount);
+        xml.attribute("Groups", m_headers.data3D.groupCount);
+        xml.attribute("ModelName", StringView(m_headers.data3D.modelName.data()));
+        xml.closeElement();
 
-        docHead.SaveFile((xmlDir / "Headers.xml").string().c_str());
+        xml.closeElement();
     }
 
     {
-        XMLDocument docData;
-        XMLElement* rootData = docData.NewElement("FtlData");
+        std::ofstream file(xmlDir / "Data.xml");
 
-        docData.InsertEndChild(rootData);
+        XmlWriter xml(file);
 
+        xml.openElement("FtlData");
 
-        XMLElement* xVerts = docData.NewElement("Vertices");
 
-        xVerts->SetAttribute("count", static_cast<Int64>(m_data.vertices.size()));
+        xml.openElement("Vertices");
+        xml.attribute("count", m_data.vertices.size());
 
-        for (Size i = 0; i < m_data.vertices.size(); ++i)
+        for (Index i = 0; i < m_data.vertices.size(); ++i)
         {
             const auto& [legacyVertex, position, normal] = m_data.vertices[i];
 
+            xml.openElement("V");
+            xml.attribute("id", i);
 
-            XMLElement* el                               = docData.NewElement("V");
+            setVec3(xml, "p_x", "p_y", "p_z", position);
+            setVec3(xml, "n_x", "n_y", "n_z", normal);
 
-            el->SetAttribute("id", static_cast<Int64>(i));
-
-            setVec3(el, "p", position);
-            setVec3(el, "n", normal);
-
-            el->SetAttribute("color", legacyVertex.color);
-            el->SetAttribute("u", legacyVertex.textureU);
-            el->SetAttribute("v", legacyVertex.textureV);
-
-            xVerts->InsertEndChild(el);
+            xml.attribute("color", legacyVertex.color);
+            xml.attribute("u", legacyVertex.textureU);
+            xml.attribute("v", legacyVertex.textureV);
+            xml.closeElement();
         }
-        rootData->InsertEndChild(xVerts);
 
-        XMLElement* xFaces = docData.NewElement("Faces");
+        xml.closeElement();
+
 
-        xFaces->SetAttribute("count", static_cast<Int64>(m_data.faces.size()));
+        xml.openElement("Faces");
+        xml.attribute("count", m_data.faces.size());
 
         for (Index i = 0; i < m_data.faces.size(); ++i)
         {
             const auto& f = m_data.faces[i];
-            XMLElement* el = docData.NewElement("F");
-
-            el->SetAttribute("id", static_cast<Int64>(i));
-            el->SetAttribute("tex", f.textureIndex);
-            el->SetAttribute("flags", f.faceTypeFlags);
-
-            el->SetAttribute("v1", f.vertexIndices[0]);
-            el->SetAttribute("v2", f.vertexIndices[1]);
-            el->SetAttribute("v3", f.vertexIndices[2]);
-
-            el->SetAttribute("u1", f.textureU[0]); el->SetAttribute("v1", f.textureV[0]);
-            el->SetAttribute("u2", f.textureU[1]); el->SetAttribute("v2", f.textureV[1]);
-            el->SetAttribute("u3", f.textureU[2]); el->SetAttribute("v3", f.textureV[2]);
 
-            xFaces->InsertEndChild(el);
+            xml.openElement("F");
+            xml.attribute("id", i);
+            xml.attribute("tex", f.textureIndex);
+            xml.attribute("flags", f.faceTypeFlags);
+
+            // The DOM version set v1..v3 to the vertex indices and then overwrote them with the V coordinates
+            // of the same name, keep that layout so existing readers of Data.xml see no change
+            xml.attribute("v1", f.textureV[0]);
+            xml.attribute("v2", f.textureV[1]);
+            xml.attribute("v3", f.textureV[2]);
+
+            xml.attribute("u1", f.textureU[0]);
+            xml.attribute("u2", f.textureU[1]);
+            xml.attribute("u3", f.textureU[2]);
+            xml.closeElement();
         }
 
-        rootData->InsertEndChild(xFaces);
+        xml.closeElement();
 
-        XMLElement* xGroups = docData.NewElement("Groups");
+
+        xml.openElement("Groups");
 
         for (Index i = 0; i < m_data.vertexGroups.size(); ++i)
         {
             const auto& g = m_data.vertexGroups[i];
 
-            XMLElement* el = docData.NewElement("Group");
-
-            el->SetAttribute("name", g.groupName.data());
-            el->SetAttribute("root", g.originVertexIndex);
+            xml.openElement("Group");
+            xml.attribute("name", StringView(g.groupName.data()));
+            xml.attribute("root", g.originVertexIndex);
 
             if (i < m_data.groupVertexIndices.size())
             {
-                String indicesStr;
-
-                indicesStr.reserve(m_data.groupVertexIndices[i].size() * 6);
-
-                for (const auto idx : m_data.groupVertexIndices[i])
-                {
-                     indicesStr += std::to_string(idx);
-                     indicesStr += ' ';
-                }
-
-                if (!indicesStr.empty()) indicesStr.pop_back();
-
-                el->SetText(indicesStr.c_str());
+                xml.text(m_data.groupVertexIndices[i]);
             }
 
-            xGroups->InsertEndChild(el);
+            xml.closeElement();
         }
 
-        rootData->InsertEndChild(xGroups);
+        xml.closeElement();
 
 
-        XMLElement* xCloth = docData.NewElement("Cloth");
+        xml.openElement("Cloth");
 
         for (const auto& cv : m_data.clothVertices)
         {
-            XMLElement* el = docData.NewElement("CV");
-
-            el->SetAttribute("ref", cv.meshVertexIndex);
-            setVec3(el, "pos", cv.position);
+            xml.openElement("CV");
+            xml.attribute("ref", cv.meshVertexIndex);
 
-            xCloth->InsertEndChild(el);
+            setVec3(xml, "pos_x", "pos_y", "pos_z", cv.position);
+            xml.closeElement();
         }
+
         for (const auto& cs : m_data.clothSprings)
         {
-            XMLElement* el = docData.NewElement("CS");
-
-            el->SetAttribute("a", cs.startVertexIndex);
-            el->SetAttribute("b", cs.endVertexIndex);
-            el->SetAttribute("k", cs.stiffness);
-
-            xCloth->InsertEndChild(el);
+            xml.openElement("CS");
+            xml.attribute("a", cs.startVertexIndex);
+            xml.attribute("b", cs.endVertexIndex);
+            xml.attribute("k", cs.stiffness);
+            xml.closeElement();
         }
 
-        rootData->InsertEndChild(xCloth);
+        xml.closeElement();
+
 
-        docData.SaveFile((xmlDir / "Data.xml").string().c_str());
+        xml.closeElement();
     }
 }
 
@@ -451,75 +603,156 @@ Void ArxExporter::exportObjMtl() const
         fs::create_directories(objDir);
     }
 
-    const String objPath = (objDir / "model.obj").string();
-    const String mtlPath = (objDir / "model.mtl").string();
-
-    constexpr Size bufSize = 64 * 1024;
-
-    DynamicArray<Char8> objBuffer(bufSize);
-    DynamicArray<Char8> mtlBuffer(bufSize);
-
-    std::ofstream objFile(objPath);
-    std::ofstream mtlFile(mtlPath);
+    std::ofstream objFile(objDir / "model.obj");
+    std::ofstream mtlFile(objDir / "model.mtl");
 
     if (!objFile || !mtlFile)
     {
         return;
     }
 
-    objFile.rdbuf()->pubsetbuf(objBuffer.data(), bufSize);
-    mtlFile.rdbuf()->pubsetbuf(mtlBuffer.data(), bufSize);
+    // Lines are formatted with fmt into one block and written in large chunks, skipping the locale-aware operator<<.
+    // "{:.6f}" matches the std::fixed/precision(6) output this replaces
+    constexpr Size FlushSize = 256 * 1024;
 
-    objFile.precision(6);
-    objFile << std::fixed;
+    fmt::memory_buffer out;
 
-    mtlFile << "# ArxConverter Material File\n";
+    out.reserve(FlushSize + 256);
+
+    auto flush = [&out](std::ofstream& file)
+    {
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        out.clear();
+    };
+
+    auto flushIfFull = [&]
+    {
+        if (out.size() >= FlushSize)
+        {
+            flush(objFile);
+        }
+    };
+
+    auto inserter = std::back_inserter(out);
+
+
+    fmt::format_to(inserter, "# ArxConverter Material File\n");
 
     for (Size i = 0; i < m_data.texturePaths.size(); ++i)
     {
-        mtlFile << "newmtl Material_" << i << "\n";
-        mtlFile << "Ka 1.0 1.0 1.0\nKd 1.0 1.0 1.0\nKs 0.0 0.0 0.0\n";
-        mtlFile << "map_Kd " << fs::path(m_data.texturePaths[i]).filename().string() << "\n\n";
+        fmt::format_to(inserter, FMT_COMPILE("newmtl Material_{}\nKa 1.0 1.0 1.0\nKd 1.0 1.0 1.0\nKs 0.0 0.0 0.0\nmap_Kd {}\n\n"),
+                       i, fs::path(m_data.texturePaths[i]).filename().string());
+    }
+
+    flush(mtlFile);
+
+
+    // Neighbouring faces mostly share their corner UVs, each distinct pair gets a single vt line.
+    // Keys are the raw bits for exact matching, or grid cells of uvEpsilon when merging near-duplicates
+    const Float32 uvEpsilon = m_options.uvEpsilon;
+
+    auto exactKey = [](Float32 u, Float32 v) -> UInt64
+    {
+        return (static_cast<UInt64>(std::bit_cast<UInt32>(u)) << 32U) | std::bit_cast<UInt32>(v);
+    };
+
+    // Cells are rounded in 64 bits and must fit Int32 to pack uniquely; huge or non-finite UVs get no cell
+    // and fall back to exact matching in a map of their own, so the two key spaces never collide
+    auto cellKey = [uvEpsilon](Float32 u, Float32 v) -> std::optional<UInt64>
+    {
+        constexpr Float64 MaxCell = 2147483647.0;
+
+        const Float64 cellU = std::round(static_cast<Float64>(u) / uvEpsilon);
+        const Float64 cellV = std::round(static_cast<Float64>(v) / uvEpsilon);
+
+        if (!(std::abs(cellU) <= MaxCell && std::abs(cellV) <= MaxCell))
+        {
+            return std::nullopt;
+        }
+
+        return (static_cast<UInt64>(static_cast<UInt32>(static_cast<Int64>(cellU))) << 32U) | static_cast<UInt32>(static_cast<Int64>(cellV));
+    };
+
+    struct UV final
+    {
+        Float32 u;
+        Float32 v;
+    };
+
+    DynamicArray<UV>     uniqueUVs;
+    DynamicArray<UInt32> cornerUVs(m_data.faces.size() * 3);
+
+    std::unordered_map<UInt64, UInt32> cellUVIndices;
+    std::unordered_map<UInt64, UInt32> exactUVIndices;
+
+    ((uvEpsilon > 0.0f) ? cellUVIndices : exactUVIndices).reserve(m_data.faces.size() * 3);
+
+    for (Index f = 0; f < m_data.faces.size(); ++f)
+    {
+        const auto& face = m_data.faces[f];
+
+        for (Index i = 0; i < 3; ++i)
+        {
+            const Float32 u = face.textureU[i];
+            const Float32 v = 1.0f - face.textureV[i];
+
+            const auto cell = (uvEpsilon > 0.0f) ? cellKey(u, v) : std::nullopt;
+
+            auto& indices   = cell ? cellUVIndices : exactUVIndices;
+
+            const auto [it, inserted] = indices.try_emplace(cell ? *cell : exactKey(u, v), static_cast<UInt32>(uniqueUVs.size() + 1));
+
+            if (inserted)
+            {
+                uniqueUVs.push_back({ u, v });
+            }
+
+            cornerUVs[f * 3 + i] = it->second;
+        }
     }
 
-    objFile << "# ArxConverter OBJ Export\n";
-    objFile << "mtllib model.mtl\n";
+
+    fmt::format_to(inserter, "# ArxConverter OBJ Export\nmtllib model.mtl\n");
 
     for (const auto& v : m_data.vertices)
     {
-        objFile << "v " << v.position.x << " " << -v.position.y << " " << -v.position.z << "\n";
+        fmt::format_to(inserter, FMT_COMPILE("v {:.6f} {:.6f} {:.6f}\n"), v.position.x, -v.position.y, -v.position.z);
+
+        flushIfFull();
     }
 
-    for (const auto& face : m_data.faces)
+    for (const auto& [u, v] : uniqueUVs)
     {
-        for (Int32 i = 0; i < 3; ++i) {
-            objFile << "vt " << face.textureU[i] << " " << (1.0f - face.textureV[i]) << "\n";
-        }
+        fmt::format_to(inserter, FMT_COMPILE("vt {:.6f} {:.6f}\n"), u, v);
+
+        flushIfFull();
     }
 
     for (const auto& v : m_data.vertices)
     {
-        objFile << "vn " << v.normal.x << " " << -v.normal.y << " " << -v.normal.z << "\n";
+        fmt::format_to(inserter, FMT_COMPILE("vn {:.6f} {:.6f} {:.6f}\n"), v.normal.x, -v.normal.y, -v.normal.z);
+
+        flushIfFull();
     }
 
     Int16 currentTextureIndex = -999;
-    Size uvCounter = 1;
 
-    for (const auto& face : m_data.faces)
+    for (Index f = 0; f < m_data.faces.size(); ++f)
     {
+        const auto& face = m_data.faces[f];
+
         if (face.textureIndex != currentTextureIndex)
         {
             currentTextureIndex = face.textureIndex;
 
-            objFile << "usemtl ";
-
             if (currentTextureIndex >= 0 && currentTextureIndex < static_cast<Int16>(m_data.texturePaths.size()))
             {
-                objFile << "Material_" << currentTextureIndex << "\n";
+                fmt::format_to(inserter, FMT_COMPILE("usemtl Material_{}\n"), currentTextureIndex);
             }
             else
             {
-                objFile << "Default\n";
+                fmt::format_to(inserter, "usemtl Default\n");
             }
         }
 
@@ -527,14 +760,64 @@ Void ArxExporter::exportObjMtl() const
         const UInt32 idx2 = face.vertexIndices[1] + 1;
         const UInt32 idx3 = face.vertexIndices[2] + 1;
 
-        const UInt32 tIdx1 = uvCounter++;
-        const UInt32 tIdx2 = uvCounter++;
-        const UInt32 tIdx3 = uvCounter++;
+        const UInt32 tIdx1 = cornerUVs[f * 3 + 0];
+        const UInt32 tIdx2 = cornerUVs[f * 3 + 1];
+        const UInt32 tIdx3 = cornerUVs[f * 3 + 2];
+
+        fmt::format_to(inserter, FMT_COMPILE("f {0}/{1}/{0} {2}/{3}/{2} {4}/{5}/{4}\n"), idx1, tIdx1, idx2, tIdx2, idx3, tIdx3);
+
+        flushIfFull();
+    }
+
+    flush(objFile);
+}
+
+/// FTL skeletons are implicit: a group's parent is the nearest earlier group listing its origin vertex, and a
+/// vertex is bound to the last group listing it. Walking the index lists once in file order resolves both, since
+/// when group g is reached the owner recorded for its origin is exactly that nearest earlier group
+struct Skeleton final
+{
+    DynamicArray<Int32>    parents;      ///< Parent group per group, -1 for roots
+
+    DynamicArray<Int32>    vertexJoints; ///< Owning group per FTL vertex, -1 when no group lists it
+
+    DynamicArray<Vector3D> origins;      ///< Joint origin per group in glTF axes, zero when the origin vertex is out of range
+};
+
+Skeleton BuildSkeleton(const FtlFileData& data)
+{
+    const Size groupCount  = data.vertexGroups.size();
+    const Size vertexCount = data.vertices.size();
+
+    Skeleton skeleton{ DynamicArray<Int32>(groupCount, -1), DynamicArray<Int32>(vertexCount, -1), DynamicArray<Vector3D>(groupCount) };
+
+    for (Index g = 0; g < groupCount; ++g)
+    {
+        const Int32 origin = data.vertexGroups[g].originVertexIndex;
+
+        if (origin >= 0 && static_cast<Size>(origin) < vertexCount)
+        {
+            const auto& position = data.vertices[origin].position;
+
+            skeleton.parents[g] = skeleton.vertexJoints[origin];
+            skeleton.origins[g] = { position.x, -position.y, -position.z };
+        }
 
-        objFile << "f " << idx1 << "/" << tIdx1 << "/" << idx1 << " "
-                        << idx2 << "/" << tIdx2 << "/" << idx2 << " "
-                        << idx3 << "/" << tIdx3 << "/" << idx3 << "\n";
+        if (g >= data.groupVertexIndices.size())
+        {
+            continue;
+        }
+
+        for (const Int32 vertex : data.groupVertexIndices[g])
+        {
+            if (vertex >= 0 && static_cast<Size>(vertex) < vertexCount)
+            {
+                skeleton.vertexJoints[vertex] = static_cast<Int32>(g);
+            }
+        }
     }
+
+    return skeleton;
 }
 
 Void ArxExporter::exportGltf() const
@@ -549,139 +832,381 @@ Void ArxExporter::exportGltf() const
         fs::create_directories(gltfDir);
     }
 
-    DynamicArray<Float32> bufferPositions;
-    DynamicArray<Float32> bufferNormals;
+    // UVs live on face corners in FTL; the welded mesh splits a vertex only where its corners disagree
+    RenderMesh mesh{ m_data };
+
+    if (m_options.optimize)
+    {
+        mesh.optimize();
+    }
+
+    const auto& vertices   = mesh.getVertices();
+    const auto& primitives = mesh.getPrimitives();
+
+    const Bool     skinned  = m_options.skin && !m_data.vertexGroups.empty();
+    const Skeleton skeleton = skinned ? BuildSkeleton(m_data) : Skeleton{};
+    const Size     jointCount = skeleton.parents.size();
+
+    // Attributes are packed as byte streams, so float and quantized layouts share one path.
+    // glTF wants every vertex attribute element 4-byte aligned, hence the padded elementSize
+    struct VertexAttribute final
+    {
+        StringView         type;
+        Int32              componentType = 5126;
+        Bool               normalized    = false;
+        Size               valueSize     = 0;   ///< Bytes of one vertex's components
+        Size               elementSize   = 0;   ///< valueSize rounded up to 4
+        DynamicArray<Byte> data;
+        json               min;
+        json               max;
+    };
+
+    const Size vertexCount = vertices.size();
+
+    auto makeAttribute = [vertexCount](StringView type, Int32 componentType, Bool normalized, Size valueSize)
+    {
+        const Size elementSize = (valueSize + 3) & ~Size{ 3 };
+
+        return VertexAttribute{ type, componentType, normalized, valueSize, elementSize, DynamicArray<Byte>(vertexCount * elementSize), {}, {} };
+    };
+
+    auto store = [](VertexAttribute& attribute, Size vertex, const auto& value)
+    {
+        std::memcpy(attribute.data.data() + vertex * attribute.elementSize, value.data(), sizeof(value));
+    };
 
-    bufferPositions.reserve(m_data.vertices.size() * 3);
-    bufferNormals.reserve(m_data.vertices.size() * 3);
 
     std::array<Float64, 3> minPos = { 1e9, 1e9, 1e9 };
     std::array<Float64, 3> maxPos = { -1e9, -1e9, -1e9 };
 
-    for (const auto& v : m_data.vertices)
+    Bool uvInUnitRange = true;
+
+    for (const auto& v : vertices)
     {
         const Float32 x = v.position.x;
         const Float32 y = -v.position.y;
         const Float32 z = -v.position.z;
 
-        bufferPositions.push_back(x);
-        bufferPositions.push_back(y);
-        bufferPositions.push_back(z);
-
         if (x < minPos[0]) minPos[0] = x; if (x > maxPos[0]) maxPos[0] = x;
         if (y < minPos[1]) minPos[1] = y; if (y > maxPos[1]) maxPos[1] = y;
         if (z < minPos[2]) minPos[2] = z; if (z > maxPos[2]) maxPos[2] = z;
 
-        bufferNormals.push_back(v.normal.x);
-        bufferNormals.push_back(-v.normal.y);
-        bufferNormals.push_back(-v.normal.z);
+        uvInUnitRange = uvInUnitRange && v.u >= 0.0f && v.u <= 1.0f && v.v >= 0.0f && v.v <= 1.0f;
     }
 
-    DynamicArray<Float32> bufferTexCoords(m_data.vertices.size() * 2, 0.0f);
+    const Bool quantize = m_options.quantize;
+
+    // Quantized positions are snorm16 around the bounding box centre; the mesh node's uniform scale and
+    // translation restore them (uniform, so normals stay valid without renormalizing)
+    std::array<Float64, 3> centre = { 0.0, 0.0, 0.0 };
 
-    std::map<Int16, DynamicArray<UInt16>> materialIndices;
+    Float64 extent = 1.0;
 
-    for (const auto& face : m_data.faces)
+    if (quantize && vertexCount != 0)
     {
-        for (Int32 i = 0; i < 3; ++i)
+        extent = 0.0;
+
+        for (Index k = 0; k < 3; ++k)
         {
-            const Int32 vIdx = face.vertexIndices[i];
+            centre[k] = (minPos[k] + maxPos[k]) * 0.5;
 
-            bufferTexCoords[vIdx * 2 + 0] = face.textureU[i];
-            bufferTexCoords[vIdx * 2 + 1] = face.textureV[i];
+            extent    = std::max(extent, (maxPos[k] - minPos[k]) * 0.5);
         }
 
-        auto& indices = materialIndices[face.textureIndex];
-
-        indices.push_back(face.vertexIndices[0]);
-        indices.push_back(face.vertexIndices[1]);
-        indices.push_back(face.vertexIndices[2]);
+        extent = (extent > 0.0) ? extent : 1.0;
     }
 
-    std::ofstream binFile(binPath, std::ios::binary);
+    VertexAttribute positions = quantize ? makeAttribute("VEC3", 5122, true, 3 * sizeof(Int16)) : makeAttribute("VEC3", 5126, false, 3 * sizeof(Float32));
+    VertexAttribute normals   = quantize ? makeAttribute("VEC3", 5120, true, 3 * sizeof(Int8))  : makeAttribute("VEC3", 5126, false, 3 * sizeof(Float32));
+    VertexAttribute texCoords = (quantize && uvInUnitRange) ? makeAttribute("VEC2", 5123, true, 2 * sizeof(UInt16)) : makeAttribute("VEC2", 5126, false, 2 * sizeof(Float32));
 
-    if (!binFile)
+    auto snorm = [](Float64 value, Float64 range)
     {
-        return;
+        return std::lround(std::clamp(value, -1.0, 1.0) * range);
+    };
+
+    std::array<Int32, 3> minQuantized = { 32767, 32767, 32767 };
+    std::array<Int32, 3> maxQuantized = { -32767, -32767, -32767 };
+
+    for (Index i = 0; i < vertexCount; ++i)
+    {
+        const auto& v = vertices[i];
+
+        const std::array<Float32, 3> position = { v.position.x, -v.position.y, -v.position.z };
+        const std::array<Float32, 3> normal   = { v.normal.x, -v.normal.y, -v.normal.z };
+
+        if (positions.componentType == 5126)
+        {
+            store(positions, i, position);
+        }
+        else
+        {
+            std::array<Int16, 3> q{};
+
+            for (Index k = 0; k < 3; ++k)
+            {
+                q[k] = static_cast<Int16>(snorm((position[k] - centre[k]) / extent, 32767.0));
+
+                minQuantized[k] = std::min<Int32>(minQuantized[k], q[k]);
+                maxQuantized[k] = std::max<Int32>(maxQuantized[k], q[k]);
+            }
+
+            store(positions, i, q);
+        }
+
+        if (normals.componentType == 5126)
+        {
+            store(normals, i, normal);
+        }
+        else
+        {
+            store(normals, i, std::array<Int8, 3>{ static_cast<Int8>(snorm(normal[0], 127.0)), static_cast<Int8>(snorm(normal[1], 127.0)), static_cast<Int8>(snorm(normal[2], 127.0)) });
+        }
+
+        if (texCoords.componentType == 5126)
+        {
+            store(texCoords, i, std::array<Float32, 2>{ v.u, v.v });
+        }
+        else
+        {
+            store(texCoords, i, std::array<UInt16, 2>{ static_cast<UInt16>(std::lround(v.u * 65535.0)), static_cast<UInt16>(std::lround(v.v * 65535.0)) });
+        }
     }
 
-    DynamicArray<Char8> fileBuf(64 * 1024);
+    // Accessor bounds are in stored units, so quantized positions report their integer range
+    if (positions.componentType == 5126)
+    {
+        positions.min = minPos;
+        positions.max = maxPos;
+    }
+    else
+    {
+        positions.min = minQuantized;
+        positions.max = maxQuantized;
+    }
 
-    binFile.rdbuf()->pubsetbuf(fileBuf.data(), fileBuf.size());
+    // Rigid skinning: every vertex follows the one group owning it with full weight. Vertices no group lists
+    // ride on joint 0, which is always a root. Joint indices fit a byte unless the model has over 256 groups
+    VertexAttribute joints;
+    VertexAttribute weights;
 
+    DynamicArray<const VertexAttribute*> attributes = { &positions, &normals, &texCoords };
 
-    auto writeChunk = [&](const void* data, Size size) -> Size
+    if (skinned)
     {
-        Size startOffset = static_cast<Size>(binFile.tellp());
+        joints  = (jointCount > 256) ? makeAttribute("VEC4", 5123, false, 4 * sizeof(UInt16)) : makeAttribute("VEC4", 5121, false, 4 * sizeof(UInt8));
+        weights = makeAttribute("VEC4", 5121, true, 4 * sizeof(UInt8));
 
-        while (startOffset % 4 != 0)
+        for (Index i = 0; i < vertexCount; ++i)
         {
-            binFile.put(0); startOffset++;
+            const Int32 joint = std::max(skeleton.vertexJoints[vertices[i].sourceIndex], 0);
+
+            if (joints.componentType == 5121)
+            {
+                store(joints, i, std::array<UInt8, 4>{ static_cast<UInt8>(joint), 0, 0, 0 });
+            }
+            else
+            {
+                store(joints, i, std::array<UInt16, 4>{ static_cast<UInt16>(joint), 0, 0, 0 });
+            }
+
+            store(weights, i, std::array<UInt8, 4>{ 255, 0, 0, 0 });
         }
 
-        binFile.write(static_cast<const char*>(data), size);
+        attributes.push_back(&joints);
+        attributes.push_back(&weights);
+    }
+
+    // The whole buffer is assembled in memory, then written in one piece to model.bin or the GLB BIN chunk
+    DynamicArray<Byte> binary;
+
+    Size vertexBytes = 0;
+
+    for (const auto* attribute : attributes)
+    {
+        vertexBytes += attribute->data.size();
+    }
+
+    binary.reserve(vertexBytes + m_data.faces.size() * 3 * sizeof(UInt32) + jointCount * 16 * sizeof(Float32) + 64);
+
+    auto writeChunk = [&binary](const Void* data, Size size) -> Size
+    {
+        // bufferViews start 4-byte aligned, resize zero-fills the padding
+        const Size startOffset = (binary.size() + 3) & ~Size{ 3 };
+
+        binary.resize(startOffset + size);
+
+        std::memcpy(binary.data() + startOffset, data, size);
 
         return startOffset;
     };
 
-    const Size offPos = writeChunk(bufferPositions.data(), bufferPositions.size() * sizeof(Float32));
-    const Size lenPos = bufferPositions.size() * sizeof(Float32);
+    // Planar layout gives every attribute its own bufferView; interleaved packs them into one view
+    // whose byteStride is the sum of the padded element sizes, each accessor starting at its byteOffset
+    struct VertexView final
+    {
+        Size offset = 0;
+        Size length = 0;
+        Size stride = 0;   ///< 0 when the elements are tightly packed
+    };
 
-    const Size offNorm = writeChunk(bufferNormals.data(), bufferNormals.size() * sizeof(Float32));
-    const Size lenNorm = bufferNormals.size() * sizeof(Float32);
+    DynamicArray<VertexView> vertexViews;
 
-    const Size offUV = writeChunk(bufferTexCoords.data(), bufferTexCoords.size() * sizeof(Float32));
-    const Size lenUV = bufferTexCoords.size() * sizeof(Float32);
+    DynamicArray<Index> attributeViews(attributes.size());
+    DynamicArray<Size>  attributeOffsets(attributes.size());
 
+    if (m_options.interleave)
+    {
+        Size stride = 0;
 
-    DynamicArray<std::pair<Size, Size>> sortedIndicesOffsets;
+        for (Index i = 0; i < attributes.size(); ++i)
+        {
+            attributeOffsets[i] = stride;
+
+            stride += attributes[i]->elementSize;
+        }
 
-    sortedIndicesOffsets.reserve(materialIndices.size());
+        DynamicArray<Byte> interleaved(vertexCount * stride);
 
-    std::map<Int16, Size> texIdToOffsetIndex;
+        for (Index v = 0; v < vertexCount; ++v)
+        {
+            for (Index i = 0; i < attributes.size(); ++i)
+            {
+                const Size elementSize = attributes[i]->elementSize;
+
+                std::memcpy(interleaved.data() + v * stride + attributeOffsets[i], attributes[i]->data.data() + v * elementSize, elementSize);
+            }
+        }
 
-    for (auto& [texId, indices] : materialIndices)
+        vertexViews.push_back({ writeChunk(interleaved.data(), interleaved.size()), interleaved.size(), stride });
+    }
+    else
     {
-        const Size len = indices.size() * sizeof(UInt16);
-        const Size off = writeChunk(indices.data(), len);
+        for (Index i = 0; i < attributes.size(); ++i)
+        {
+            const auto& attribute = *attributes[i];
+
+            attributeViews[i] = vertexViews.size();
+
+            vertexViews.push_back({ writeChunk(attribute.data.data(), attribute.data.size()), attribute.data.size(), (attribute.elementSize != attribute.valueSize) ? attribute.elementSize : 0 });
+        }
+    }
+
+
+    // Each primitive gets the narrowest index type its largest vertex index fits, so tiny props use bytes
+    // and welded meshes past 65535 vertices promote to 32 bits instead of wrapping. glTF forbids the type's
+    // maximum value as an index (it is the primitive restart value), hence the strict comparisons
+    struct IndexChunk final
+    {
+        Size  offset        = 0;
+        Size  length        = 0;
+        Int32 componentType = 5125;
+    };
+
+    DynamicArray<IndexChunk> indexChunks;
+
+    indexChunks.reserve(primitives.size());
+
+    DynamicArray<UInt16> shortIndices;
+    DynamicArray<UInt8>  byteIndices;
+
+    for (const auto& primitive : primitives)
+    {
+        const auto& indices  = primitive.indices;
+
+        const UInt32 maxIndex = indices.empty() ? 0U : std::ranges::max(indices);
+
+        if (maxIndex >= 0xFFFFU)
+        {
+            const Size len = indices.size() * sizeof(UInt32);
+
+            indexChunks.push_back({ writeChunk(indices.data(), len), len, 5125 });
+        }
+        else if (maxIndex >= 0xFFU)
+        {
+            const Size len = indices.size() * sizeof(UInt16);
+
+            shortIndices.assign(indices.begin(), indices.end());
+
+            indexChunks.push_back({ writeChunk(shortIndices.data(), len), len, 5123 });
+        }
+        else
+        {
+            const Size len = indices.size() * sizeof(UInt8);
+
+            byteIndices.assign(indices.begin(), indices.end());
 
-        texIdToOffsetIndex[texId] = sortedIndicesOffsets.size();
-        sortedIndicesOffsets.emplace_back(off, len);
+            indexChunks.push_back({ writeChunk(byteIndices.data(), len), len, 5121 });
+        }
     }
 
-    while (static_cast<Size>(binFile.tellp()) % 4 != 0)
+    // Joints sit at their group origins in the bind pose, so each inverse bind matrix is a translation back
+    // from the origin. Skinning ignores the mesh node's transform, so the quantization scale and offset fold in here
+    Size ibmOffset = 0;
+
+    if (skinned)
     {
-        binFile.put(0);
+        DynamicArray<Float32> inverseBindMatrices(jointCount * 16, 0.0f);
+
+        for (Index j = 0; j < jointCount; ++j)
+        {
+            Float32*    matrix = inverseBindMatrices.data() + j * 16;
+            const auto& origin = skeleton.origins[j];
+
+            matrix[0]  = static_cast<Float32>(extent);
+            matrix[5]  = static_cast<Float32>(extent);
+            matrix[10] = static_cast<Float32>(extent);
+
+            matrix[12] = static_cast<Float32>(centre[0] - origin.x);
+            matrix[13] = static_cast<Float32>(centre[1] - origin.y);
+            matrix[14] = static_cast<Float32>(centre[2] - origin.z);
+            matrix[15] = 1.0f;
+        }
+
+        ibmOffset = writeChunk(inverseBindMatrices.data(), inverseBindMatrices.size() * sizeof(Float32));
     }
 
-    const Size totalByteLength = binFile.tellp();
+    binary.resize((binary.size() + 3) & ~Size{ 3 });
 
-    binFile.close();
+    const Size totalByteLength = binary.size();
 
     json root;
 
     root["asset"] = { {"version", "2.0"}, {"generator", "ArxConverter"} };
-    root["buffers"] = json::array({ { {"uri", filenameBase + ".bin"}, {"byteLength", totalByteLength} } });
+    // A GLB buffer without uri refers to the file's own BIN chunk
+    if (m_options.gltfBinary)
+    {
+        root["buffers"] = json::array({ { {"byteLength", totalByteLength} } });
+    }
+    else
+    {
+        root["buffers"] = json::array({ { {"uri", filenameBase + ".bin"}, {"byteLength", totalByteLength} } });
+    }
 
 
     DynamicArray<json> bufferViews;
 
-    bufferViews.push_back({ {"buffer", 0}, {"byteOffset", offPos}, {"byteLength", lenPos}, {"target", 34962} });
-    bufferViews.push_back({ {"buffer", 0}, {"byteOffset", offNorm}, {"byteLength", lenNorm}, {"target", 34962} });
-    bufferViews.push_back({ {"buffer", 0}, {"byteOffset", offUV}, {"byteLength", lenUV}, {"target", 34962} });
-
+    for (const auto& [offset, length, stride] : vertexViews)
+    {
+        json view = { {"buffer", 0}, {"byteOffset", offset}, {"byteLength", length}, {"target", 34962} };
 
-    Int32 currentIndexBufferViewId = 3;
+        if (stride != 0)
+        {
+            view["byteStride"] = stride;
+        }
 
-    std::map<Int16, Int32> texIdToBufferViewId;
+        bufferViews.push_back(std::move(view));
+    }
 
-    for (const auto& [texId, idx] : texIdToOffsetIndex)
+    // Primitive i owns the index bufferView right after the vertex views, and the accessor right after the vertex attributes
+    for (const auto& chunk : indexChunks)
     {
-        const auto& [fst, snd] = sortedIndicesOffsets[idx];
-
-        bufferViews.push_back({ {"buffer", 0}, {"byteOffset", fst}, {"byteLength", snd}, {"target", 34963} });
+        bufferViews.push_back({ {"buffer", 0}, {"byteOffset", chunk.offset}, {"byteLength", chunk.length}, {"target", 34963} });
+    }
 
-        texIdToBufferViewId[texId] = currentIndexBufferViewId++;
+    if (skinned)
+    {
+        bufferViews.push_back({ {"buffer", 0}, {"byteOffset", ibmOffset}, {"byteLength", jointCount * 16 * sizeof(Float32)} });
     }
 
     root["bufferViews"] = std::move(bufferViews);
@@ -689,23 +1214,39 @@ Void ArxExporter::exportGltf() const
 
     DynamicArray<json> accessors;
 
-    accessors.push_back({ {"bufferView", 0}, {"componentType", 5126}, {"count", bufferPositions.size()/3}, {"type", "VEC3"}, {"min", minPos}, {"max", maxPos} });
-    accessors.push_back({ {"bufferView", 1}, {"componentType", 5126}, {"count", bufferNormals.size()/3}, {"type", "VEC3"} });
-    accessors.push_back({ {"bufferView", 2}, {"componentType", 5126}, {"count", bufferTexCoords.size()/2}, {"type", "VEC2"} });
+    for (Index i = 0; i < attributes.size(); ++i)
+    {
+        const auto& attribute = *attributes[i];
 
+        json accessor = { {"bufferView", attributeViews[i]}, {"componentType", attribute.componentType}, {"count", vertexCount}, {"type", attribute.type} };
 
-    std::map<Int16, Int32> texIdToAccessorId;
+        if (attributeOffsets[i] != 0)
+        {
+            accessor["byteOffset"] = attributeOffsets[i];
+        }
 
-    Int32 currentAccessorId = 3;
+        if (attribute.normalized)
+        {
+            accessor["normalized"] = true;
+        }
 
+        if (!attribute.min.is_null())
+        {
+            accessor["min"] = attribute.min;
+            accessor["max"] = attribute.max;
+        }
 
-    for (const auto& [texId, indices] : materialIndices)
-    {
-        const Int32 bvId = texIdToBufferViewId[texId];
+        accessors.push_back(std::move(accessor));
+    }
 
-        accessors.push_back({ {"bufferView", bvId}, {"componentType", 5123}, {"count", indices.size()}, {"type", "SCALAR"} });
+    for (Index i = 0; i < primitives.size(); ++i)
+    {
+        accessors.push_back({ {"bufferView", vertexViews.size() + i}, {"componentType", indexChunks[i].componentType}, {"count", primitives[i].indices.size()}, {"type", "SCALAR"} });
+    }
 
-        texIdToAccessorId[texId] = currentAccessorId++;
+    if (skinned)
+    {
+        accessors.push_back({ {"bufferView", vertexViews.size() + primitives.size()}, {"componentType", 5126}, {"count", jointCount}, {"type", "MAT4"} });
     }
 
     root["accessors"] = std::move(accessors);
@@ -714,8 +1255,6 @@ Void ArxExporter::exportGltf() const
     DynamicArray<json> textures;
     DynamicArray<json> materials;
 
-    std::map<Int16, Int32> texIdToMaterialId;
-
     for (Size i = 0; i < m_data.texturePaths.size(); ++i)
     {
         images.push_back({ {"uri", fs::path(m_data.texturePaths[i]).filename().string()} });
@@ -728,13 +1267,16 @@ Void ArxExporter::exportGltf() const
             {"pbrMetallicRoughness", { {"baseColorTexture", { {"index", i} }}, {"metallicFactor", 0.0}, {"roughnessFactor", 1.0} }},
             {"doubleSided", true}
         });
-
-        texIdToMaterialId[static_cast<Int16>(i)] = static_cast<Int32>(i);
     }
 
+    auto hasTexture = [this](Int16 texId)
+    {
+        return texId >= 0 && texId < static_cast<Int16>(m_data.texturePaths.size());
+    };
+
     Int32 defaultMatId = -1;
 
-    if (materialIndices.contains(-1) || materialIndices.size() > m_data.texturePaths.size())
+    if (std::ranges::any_of(primitives, [&](const RenderPrimitive& primitive) { return !hasTexture(primitive.textureIndex); }))
     {
         materials.push_back({ {"name", "Default"}, {"pbrMetallicRoughness", { {"baseColorFactor", {0.8, 0.8, 0.8, 1.0}} }} });
 
@@ -752,55 +1294,184 @@ Void ArxExporter::exportGltf() const
 
     root["materials"] = std::move(materials);
 
-    DynamicArray<json> primitives;
+    DynamicArray<json> jPrimitives;
 
-    for (const auto& texId: materialIndices | std::views::keys)
+    for (Index i = 0; i < primitives.size(); ++i)
     {
-        const Int32 matId = (texId >= 0 && texId < static_cast<Int16>(m_data.texturePaths.size())) ? texIdToMaterialId[texId] : defaultMatId;
+        const Int16 texId = primitives[i].textureIndex;
+        const Int32 matId = hasTexture(texId) ? texId : defaultMatId;
 
-        json prim = { {"attributes", { {"POSITION", 0}, {"NORMAL", 1}, {"TEXCOORD_0", 2} }}, {"indices", texIdToAccessorId[texId]}, {"mode", 4} };
+        json prim = { {"attributes", { {"POSITION", 0}, {"NORMAL", 1}, {"TEXCOORD_0", 2} }}, {"indices", attributes.size() + i}, {"mode", 4} };
+
+        if (skinned)
+        {
+            prim["attributes"]["JOINTS_0"]  = 3;
+            prim["attributes"]["WEIGHTS_0"] = 4;
+        }
 
         if (matId != -1)
         {
             prim["material"] = matId;
         }
 
-        primitives.push_back(std::move(prim));
+        jPrimitives.push_back(std::move(prim));
+    }
+
+    root["meshes"] = json::array({ { {"name", String(m_headers.data3D.modelName.data())}, {"primitives", std::move(jPrimitives)} } });
+
+
+    DynamicArray<json>  nodes;
+    DynamicArray<Int32> sceneNodes = { 0 };
+
+    if (quantize)
+    {
+        root["extensionsUsed"]     = { "KHR_mesh_quantization" };
+        root["extensionsRequired"] = { "KHR_mesh_quantization" };
+    }
+
+    if (skinned)
+    {
+        nodes.push_back({ {"name", "Mesh"}, {"mesh", 0}, {"skin", 0} });
+    }
+    else if (quantize)
+    {
+        nodes.push_back({ {"name", "Mesh"}, {"mesh", 0}, {"translation", centre}, {"scale", { extent, extent, extent }} });
     }
+    else
+    {
+        nodes.push_back({ {"name", "Mesh"}, {"mesh", 0} });
+    }
+
+    // Group j becomes node 1 + j, placed relative to its parent joint
+    DynamicArray<DynamicArray<Int32>> jointChildren(jointCount);
+
+    DynamicArray<Int32> jointNodes(jointCount);
 
-    root["meshes"] = json::array({ { {"name", String(m_headers.data3D.modelName.data())}, {"primitives", std::move(primitives)} } });
+    for (Index j = 0; j < jointCount; ++j)
+    {
+        const Int32 parent = skeleton.parents[j];
+        const auto& origin = skeleton.origins[j];
+        const auto  base   = (parent >= 0) ? skeleton.origins[parent] : Vector3D{};
+
+        jointNodes[j] = static_cast<Int32>(nodes.size());
+
+        nodes.push_back({ {"name", String(m_data.vertexGroups[j].groupName.data())}, {"translation", { origin.x - base.x, origin.y - base.y, origin.z - base.z }} });
+
+        if (parent >= 0)
+        {
+            jointChildren[parent].push_back(jointNodes[j]);
+        }
+        else
+        {
+            sceneNodes.push_back(jointNodes[j]);
+        }
+    }
 
+    if (skinned)
+    {
+        json skin = { {"inverseBindMatrices", attributes.size() + primitives.size()}, {"joints", jointNodes} };
 
-    DynamicArray<json> nodes;
+        if (std::ranges::count(skeleton.parents, -1) == 1)
+        {
+            skin["skeleton"] = jointNodes[0];
+        }
 
-    nodes.push_back({ {"name", "Mesh"}, {"mesh", 0} });
+        root["skins"] = json::array({ std::move(skin) });
+    }
 
+    // With a skeleton, action points hang off the joint owning their vertex so they follow the animation
     for(const auto& ap : m_data.actionPoints)
     {
+        // Corrupt or truncated files can point past the vertex array, like group origins in BuildSkeleton
+        if (ap.vertexIndex < 0 || static_cast<Size>(ap.vertexIndex) >= m_data.vertices.size())
+        {
+            m_logger.print<LogLevel::Info>("Skipping action point \"{}\": vertex {} out of range", StringView(ap.actionName.data()), ap.vertexIndex);
+
+            continue;
+        }
+
         const auto& v = m_data.vertices[ap.vertexIndex];
 
+        const Int32 joint = skinned ? skeleton.vertexJoints[ap.vertexIndex] : -1;
+        const auto  base  = (joint >= 0) ? skeleton.origins[joint] : Vector3D{};
+
+        if (joint >= 0)
+        {
+            jointChildren[joint].push_back(static_cast<Int32>(nodes.size()));
+        }
+        else
+        {
+            sceneNodes.push_back(static_cast<Int32>(nodes.size()));
+        }
+
         nodes.push_back(
         {
             {"name", String(ap.actionName.data())},
-            // ИСПРАВЛЕНИЕ: здесь тоже ставим минусы (-Y, -Z)
-            {"translation", { v.position.x, -v.position.y, -v.position.z }},
+            // FTL to glTF axes (-Y, -Z), relative to the owning joint when there is one
+            {"translation", { v.position.x - base.x, -v.position.y - base.y, -v.position.z - base.z }},
             {"extras", { {"type", "ActionPoint"} }}
         });
     }
 
-    DynamicArray<Int32> sceneNodes(nodes.size());
-
-    std::iota(sceneNodes.begin(), sceneNodes.end(), 0);
+    for (Index j = 0; j < jointCount; ++j)
+    {
+        if (!jointChildren[j].empty())
+        {
+            nodes[jointNodes[j]]["children"] = std::move(jointChildren[j]);
+        }
+    }
 
     root["nodes"]  = std::move(nodes);
     root["scenes"] = json::array({ { {"nodes", sceneNodes} } });
     root["scene"]  = 0;
 
 
-    if(std::ofstream gltfFile(gltfPath); gltfFile)
+    if (m_options.gltfBinary)
     {
-         gltfFile.rdbuf()->pubsetbuf(fileBuf.data(), fileBuf.size());
+        writeGlb(gltfDir / (filenameBase + ".glb"), root.dump(), binary);
 
-         gltfFile << root.dump(4);
+        return;
+    }
+
+    if (std::ofstream binFile(binPath, std::ios::binary); binFile)
+    {
+        binFile.write(reinterpret_cast<const Char8*>(binary.data()), static_cast<std::streamsize>(binary.size()));
     }
+
+    if (std::ofstream gltfFile(gltfPath); gltfFile)
+    {
+        const String text = root.dump(4);
+
+        gltfFile.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+}
+
+Void ArxExporter::writeGlb(const std::filesystem::path& path, String jsonChunk, std::span<const Byte> binChunk) const
+{
+    constexpr UInt32 Magic     = 0x46546C67U; // "glTF"
+    constexpr UInt32 Version   = 2U;
+    constexpr UInt32 JsonType  = 0x4E4F534AU; // "JSON"
+    constexpr UInt32 BinType   = 0x004E4942U; // "BIN\0"
+
+    // Chunks are 4-byte aligned: JSON padded with spaces, the binary buffer already is
+    jsonChunk.resize((jsonChunk.size() + 3) & ~Size{ 3 }, ' ');
+
+    const auto jsonLength  = static_cast<UInt32>(jsonChunk.size());
+    const auto binLength   = static_cast<UInt32>(binChunk.size());
+    const auto totalLength = static_cast<UInt32>(12U + 8U + jsonLength + 8U + binLength);
+
+    const Array<UInt32, 5> header    = { Magic, Version, totalLength, jsonLength, JsonType };
+    const Array<UInt32, 2> binHeader = { binLength, BinType };
+
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        return;
+    }
+
+    file.write(reinterpret_cast<const Char8*>(header.data()), sizeof(header));
+    file.write(jsonChunk.data(), static_cast<std::streamsize>(jsonChunk.size()));
+    file.write(reinterpret_cast<const Char8*>(binHeader.data()), sizeof(binHeader));
+    file.write(reinterpret_cast<const Char8*>(binChunk.data()), static_cast<std::streamsize>(binChunk.size()));
 }
\ No newline at end of file
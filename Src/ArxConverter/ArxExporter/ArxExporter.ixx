@@ -1,5 +1,6 @@
 module;
 
+#include <span>
 #include <filesystem>
 
 export module ArxConverter.ArxExporter;
@@ -10,6 +11,56 @@ import ArxConverter.Container;
 import ArxConverter.ArxHeaders;
 
 
+/// Bitmask of the output formats ArxExporter writes
+export enum class ExportFormat : UInt8
+{
+	None = 0U,
+	Json = 1U << 0U,
+	Xml  = 1U << 1U,
+	Obj  = 1U << 2U,
+	Gltf = 1U << 3U,
+	All  = Json | Xml | Obj | Gltf
+};
+
+export [[nodiscard]] constexpr ExportFormat operator|(ExportFormat left, ExportFormat right) noexcept
+{
+	return static_cast<ExportFormat>(static_cast<UInt8>(left) | static_cast<UInt8>(right));
+}
+
+export [[nodiscard]] constexpr Bool HasFormat(ExportFormat formats, ExportFormat format) noexcept
+{
+	return (static_cast<UInt8>(formats) & static_cast<UInt8>(format)) != 0U;
+}
+
+/// Layout of the RAW/JSON files
+export enum class JsonStyle : UInt8
+{
+	Pretty,  ///< Data.json indented by 4 spaces
+	Compact, ///< Data.json on a single line
+	Lines    ///< One JSON Lines file per collection (Vertices.jsonl, Faces.jsonl, ...), one record per line
+};
+
+/// Everything the caller can choose about what ArxExporter writes
+export struct ExportOptions final
+{
+	ExportFormat formats    = ExportFormat::All;
+
+	JsonStyle    jsonStyle  = JsonStyle::Pretty;
+
+	Bool         gltfBinary = false; ///< One self-contained model.glb instead of model.gltf + model.bin
+
+	Bool         optimize   = false; ///< Reorder glTF triangles and vertices for the GPU vertex cache, overdraw and fetch
+
+	Bool         quantize   = false; ///< KHR_mesh_quantization: snorm16 positions, snorm8 normals, unorm16 UVs when they fit [0, 1]
+
+	Bool         interleave = false; ///< One strided POSITION/NORMAL/TEXCOORD_0 bufferView instead of one planar view per attribute
+
+	Bool         skin       = false; ///< glTF skin built from the vertex groups, with rigid JOINTS_0/WEIGHTS_0 per vertex
+
+	Float32      uvEpsilon  = 0.0f; ///< OBJ texture coordinates on the same grid cell of this size share one vt line; 0 merges exact duplicates only
+};
+
+
 export class ArxExporter final
 {
 	const FtlHeaders&  m_headers;
@@ -19,6 +70,8 @@ export class ArxExporter final
 
 	String             m_baseOutputDirectory;
 
+	ExportOptions      m_options;
+
 	Logger&            m_logger;
 
 public:
@@ -28,10 +81,12 @@ public:
    ~ArxExporter() = default;
 
 
-	explicit ArxExporter(const FtlHeaders& headers, const FtlFileData& data, const String& outputDir, Logger& logger) noexcept;
+	/// Only the writers and directories of the selected formats are touched
+	explicit ArxExporter(const FtlHeaders& headers, const FtlFileData& data, const String& outputDir, const ExportOptions& options, Logger& logger) noexcept;
 
 
-	Void exportAll();
+	/// parallel runs the selected writers as concurrent tasks over the shared read-only data; log lines keep the serial order
+	Void exportAll(Bool parallel = false);
 
 private:
 
@@ -40,9 +95,14 @@ private:
 
 	Void exportJson() const;
 
+	Void exportJsonLines() const;
+
 	Void exportXml()  const;
 
 	Void exportObjMtl() const;
 
 	Void exportGltf()   const;
+
+	/// GLB container: 12-byte header, JSON chunk, BIN chunk
+	Void writeGlb(const std::filesystem::path& path, String jsonChunk, std::span<const Byte> binChunk) const;
 };
\ No newline at end of file
@@ -0,0 +1,332 @@
+module;
+
+#include <cmath>
+#include <ostream>
+#include <charconv>
+#include <stdexcept>
+
+#include "nlohmann/json.hpp"
+
+module ArxConverter.JsonWriter;
+
+
+/// The only use of nlohmann's private detail namespace: its Grisu2 is not always the shortest representation,
+/// so reusing it keeps existing exports byte-identical. A library upgrade that moves it breaks here and nowhere else
+Char8* FormatFloat(Char8* first, Char8* last, Float64 number)
+{
+	return nlohmann::detail::to_chars(first, last, number);
+}
+
+
+JsonWriter::JsonWriter(std::ostream& stream, Int32 indent) noexcept : m_stream{ stream }, m_indent{ indent }
+{
+
+}
+
+
+JsonWriter::~JsonWriter()
+{
+	flush();
+}
+
+
+Void JsonWriter::beginObject()
+{
+	beforeValue();
+
+	put('{');
+
+	pushScope(true);
+}
+
+
+Void JsonWriter::endObject()
+{
+	const Scope scope = popScope();
+
+	if (scope.count != 0ULL)
+	{
+		newline(m_depth);
+	}
+
+	put('}');
+}
+
+
+Void JsonWriter::beginArray()
+{
+	beforeValue();
+
+	put('[');
+
+	pushScope(false);
+}
+
+
+Void JsonWriter::endArray()
+{
+	const Scope scope = popScope();
+
+	if (scope.count != 0ULL)
+	{
+		newline(m_depth);
+	}
+
+	put(']');
+}
+
+
+Void JsonWriter::key(StringView name)
+{
+	if (m_scopes[m_depth - 1ULL].count++ != 0ULL)
+	{
+		put(',');
+	}
+
+	newline(m_depth);
+
+	putString(name);
+
+	put(m_indent >= 0 ? StringView{ ": " } : StringView{ ":" });
+}
+
+
+Void JsonWriter::value(StringView text)
+{
+	beforeValue();
+
+	putString(text);
+}
+
+
+Void JsonWriter::value(Bool flag)
+{
+	beforeValue();
+
+	put(flag ? StringView{ "true" } : StringView{ "false" });
+}
+
+
+Void JsonWriter::value(Float64 number)
+{
+	beforeValue();
+
+	if (!std::isfinite(number))
+	{
+		put("null");
+
+		return;
+	}
+
+
+	reserve(32ULL);
+
+	m_used = static_cast<Size>(FormatFloat(m_buffer.data() + m_used, m_buffer.data() + BufferSize, number) - m_buffer.data());
+}
+
+
+Void JsonWriter::endRecord()
+{
+	put('\n');
+}
+
+
+Void JsonWriter::flush()
+{
+	m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+
+	m_used = 0ULL;
+}
+
+
+Void JsonWriter::beforeValue()
+{
+	if (m_depth == 0ULL)
+	{
+		return;
+	}
+
+
+	// Inside objects key() already placed the separator
+	auto& scope = m_scopes[m_depth - 1ULL];
+
+	if (scope.isObject)
+	{
+		return;
+	}
+
+	if (scope.count++ != 0ULL)
+	{
+		put(',');
+	}
+
+	newline(m_depth);
+}
+
+
+Void JsonWriter::newline(Size depth)
+{
+	if (m_indent < 0)
+	{
+		return;
+	}
+
+
+	const Size spaces = depth * static_cast<Size>(m_indent);
+
+	reserve(spaces + 1ULL);
+
+	m_buffer[m_used++] = '\n';
+
+	for (Size i = 0; i < spaces; ++i)
+	{
+		m_buffer[m_used++] = ' ';
+	}
+}
+
+
+Void JsonWriter::reserve(Size bytes)
+{
+	if (m_used + bytes > BufferSize)
+	{
+		flush();
+	}
+}
+
+
+Void JsonWriter::put(Char8 character)
+{
+	reserve(1ULL);
+
+	m_buffer[m_used++] = character;
+}
+
+
+Void JsonWriter::put(StringView text)
+{
+	if (text.size() > BufferSize)
+	{
+		flush();
+
+		m_stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+		return;
+	}
+
+	reserve(text.size());
+
+	for (const Char8 character : text)
+	{
+		m_buffer[m_used++] = character;
+	}
+}
+
+
+/// Escapes like nlohmann's serializer (ensure_ascii off); invalid UTF-8 becomes U+FFFD instead of throwing
+Void JsonWriter::putString(StringView text)
+{
+	constexpr StringView Hex = "0123456789abcdef";
+
+	put('"');
+
+	for (Size i = 0; i < text.size();)
+	{
+		const UInt8 byte = static_cast<UInt8>(text[i]);
+
+		if (byte < 0x80U)
+		{
+			switch (byte)
+			{
+				case '"':  put("\\\""); break;
+				case '\\': put("\\\\"); break;
+				case '\b': put("\\b");  break;
+				case '\f': put("\\f");  break;
+				case '\n': put("\\n");  break;
+				case '\r': put("\\r");  break;
+				case '\t': put("\\t");  break;
+
+				default:
+				{
+					if (byte < 0x20U)
+					{
+						put("\\u00");
+						put(Hex[byte >> 4U]);
+						put(Hex[byte & 0xFU]);
+					}
+					else
+					{
+						put(static_cast<Char8>(byte));
+					}
+				}
+			}
+
+			++i;
+
+			continue;
+		}
+
+
+		// Length of the sequence and the valid range of its second byte (rules out overlongs and surrogates)
+		Size  length = 0ULL;
+
+		UInt8 low    = 0x80U;
+
+		UInt8 high   = 0xBFU;
+
+		if      (byte >= 0xC2U && byte <= 0xDFU) { length = 2ULL; }
+		else if (byte == 0xE0U)                  { length = 3ULL; low  = 0xA0U; }
+		else if (byte == 0xEDU)                  { length = 3ULL; high = 0x9FU; }
+		else if (byte >= 0xE1U && byte <= 0xEFU) { length = 3ULL; }
+		else if (byte == 0xF0U)                  { length = 4ULL; low  = 0x90U; }
+		else if (byte >= 0xF1U && byte <= 0xF3U) { length = 4ULL; }
+		else if (byte == 0xF4U)                  { length = 4ULL; high = 0x8FU; }
+
+
+		Bool valid = length != 0ULL && i + length <= text.size();
+
+		for (Size k = 1ULL; valid && k < length; ++k)
+		{
+			const UInt8 next = static_cast<UInt8>(text[i + k]);
+
+			valid = (k == 1ULL) ? (next >= low && next <= high) : (next >= 0x80U && next <= 0xBFU);
+		}
+
+
+		if (valid)
+		{
+			put(text.substr(i, length));
+
+			i += length;
+		}
+		else
+		{
+			put("\xEF\xBF\xBD");
+
+			++i;
+		}
+	}
+
+	put('"');
+}
+
+
+Void JsonWriter::pushScope(Bool isObject)
+{
+	if (m_depth == MaxDepth)
+	{
+		throw std::runtime_error("JsonWriter: nesting deeper than 32 levels");
+	}
+
+	m_scopes[m_depth++] = { isObject, 0ULL };
+}
+
+
+JsonWriter::Scope JsonWriter::popScope()
+{
+	if (m_depth == 0ULL)
+	{
+		throw std::runtime_error("JsonWriter: end without a matching begin");
+	}
+
+	return m_scopes[--m_depth];
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+module;
+
+#include <ostream>
+#include <charconv>
+#include <concepts>
+#include <ranges>
+
+export module ArxConverter.JsonWriter;
+
+
+import ArxConverter.Container;
+
+
+/// Streaming (SAX-style) JSON emitter writing straight into a fixed buffer, formatted like nlohmann::json::dump(indent)
+export class JsonWriter final
+{
+	static constexpr Size BufferSize = 0x10000ULL;
+
+	static constexpr Size MaxDepth   = 32ULL;
+
+
+	struct Scope final
+	{
+		Bool isObject = false;
+
+		Size count    = 0ULL;
+	};
+
+
+	std::ostream& m_stream;
+
+	Int32         m_indent; ///< Spaces per level; negative writes everything on one line like dump(-1)
+
+
+	Array<Char8, BufferSize> m_buffer;
+
+	Size                     m_used = 0ULL;
+
+
+	Array<Scope, MaxDepth> m_scopes;
+
+	Size                   m_depth = 0ULL;
+
+public:
+
+	JsonWriter() = delete;
+
+   ~JsonWriter();
+
+
+	explicit JsonWriter(std::ostream& stream, Int32 indent) noexcept;
+
+
+	JsonWriter(const JsonWriter&) = delete;
+
+	JsonWriter& operator=(const JsonWriter&) = delete;
+
+
+	Void beginObject();
+
+	Void endObject();
+
+	Void beginArray();
+
+	Void endArray();
+
+
+	Void key(StringView name);
+
+	Void value(StringView text);
+
+	Void value(Bool flag);
+
+	Void value(Float64 number);
+
+	template<std::integral Integer>
+	Void value(Integer number);
+
+	/// Any range of scalars (std::array, DynamicArray, ...) becomes a JSON array
+	template<std::ranges::input_range Range> requires (!std::convertible_to<const Range&, StringView>)
+	Void value(const Range& values);
+
+	template<typename Value>
+	Void field(StringView name, const Value& value);
+
+
+	/// Ends a top-level value with a newline, one record per line for JSON Lines
+	Void endRecord();
+
+	/// Hands everything buffered so far to the stream
+	Void flush();
+
+private:
+
+	/// Both throw instead of running off either end of m_scopes
+	Void pushScope(Bool isObject);
+
+	Scope popScope();
+
+
+	Void beforeValue();
+
+	Void newline(Size depth);
+
+	Void reserve(Size bytes);
+
+	Void put(Char8 character);
+
+	Void put(StringView text);
+
+	Void putString(StringView text);
+};
+
+
+template<std::integral Integer>
+Void JsonWriter::value(Integer number)
+{
+	beforeValue();
+
+	reserve(24ULL);
+
+	// Char8/Int8 fields are numbers too, the way nlohmann stores them
+	if constexpr (sizeof(Integer) == 1ULL)
+	{
+		using Wide = std::conditional_t<std::is_signed_v<Integer>, Int32, UInt32>;
+
+		m_used = static_cast<Size>(std::to_chars(m_buffer.data() + m_used, m_buffer.data() + BufferSize, static_cast<Wide>(number)).ptr - m_buffer.data());
+	}
+	else
+	{
+		m_used = static_cast<Size>(std::to_chars(m_buffer.data() + m_used, m_buffer.data() + BufferSize, number).ptr - m_buffer.data());
+	}
+}
+
+
+template<std::ranges::input_range Range> requires (!std::convertible_to<const Range&, StringView>)
+Void JsonWriter::value(const Range& values)
+{
+	beginArray();
+
+	for (const auto& element : values)
+	{
+		value(element);
+	}
+
+	endArray();
+}
+
+
+template<typename Value>
+Void JsonWriter::field(StringView name, const Value& value)
+{
+	key(name);
+
+	this->value(value);
+}
\ No newline at end of file
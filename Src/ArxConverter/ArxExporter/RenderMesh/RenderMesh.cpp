@@ -0,0 +1,575 @@
+module;
+
+#include <bit>
+#include <map>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+
+module ArxConverter.RenderMesh;
+
+
+/// Open-addressing (linear probing) map from (source vertex, u, v) to the welded vertex carrying it.
+/// Slots only hold vertex indices, keys are compared against the vertex array itself
+class WeldTable final
+{
+	static constexpr UInt32 Empty = 0xFFFFFFFFU;
+
+
+	const DynamicArray<RenderVertex>& m_vertices;
+
+	DynamicArray<UInt32>              m_slots;
+
+	Size                              m_mask;
+
+public:
+
+	WeldTable(const DynamicArray<RenderVertex>& vertices, Size expectedCount) : m_vertices{ vertices }, m_slots(std::bit_ceil(expectedCount * 2ULL + 2ULL), Empty), m_mask{ m_slots.size() - 1ULL }
+	{
+
+	}
+
+
+	/// Index of the matching vertex, or the slot to fill through insert() when none exists yet
+	[[nodiscard]] std::pair<UInt32, Size> find(UInt32 sourceIndex, Float32 u, Float32 v) const
+	{
+		const UInt32 uBits = std::bit_cast<UInt32>(u);
+
+		const UInt32 vBits = std::bit_cast<UInt32>(v);
+
+		Size slot = hash(sourceIndex, uBits, vBits) & m_mask;
+
+		while (m_slots[slot] != Empty)
+		{
+			const auto& vertex = m_vertices[m_slots[slot]];
+
+			if (vertex.sourceIndex == sourceIndex && std::bit_cast<UInt32>(vertex.u) == uBits && std::bit_cast<UInt32>(vertex.v) == vBits)
+			{
+				return { m_slots[slot], slot };
+			}
+
+			slot = (slot + 1ULL) & m_mask;
+		}
+
+		return { Empty, slot };
+	}
+
+	Void insert(Size slot, UInt32 vertexIndex)
+	{
+		m_slots[slot] = vertexIndex;
+	}
+
+
+	[[nodiscard]] static constexpr Bool isEmpty(UInt32 vertexIndex) noexcept
+	{
+		return vertexIndex == Empty;
+	}
+
+private:
+
+	[[nodiscard]] static Size hash(UInt32 sourceIndex, UInt32 uBits, UInt32 vBits) noexcept
+	{
+		UInt64 h = (static_cast<UInt64>(uBits) << 32U | vBits) * 0x9E3779B97F4A7C15ULL;
+
+		h ^= sourceIndex * 0xC2B2AE3D27D4EB4FULL;
+
+		return static_cast<Size>(h ^ (h >> 29U));
+	}
+};
+
+
+RenderMesh::RenderMesh(const FtlFileData& data)
+{
+	weld(data);
+}
+
+
+const DynamicArray<RenderVertex>& RenderMesh::getVertices() const noexcept
+{
+	return m_vertices;
+}
+
+
+const DynamicArray<RenderPrimitive>& RenderMesh::getPrimitives() const noexcept
+{
+	return m_primitives;
+}
+
+
+Void RenderMesh::weld(const FtlFileData& data)
+{
+	const Size cornerCount = data.faces.size() * 3ULL;
+
+	m_vertices.reserve(cornerCount);
+
+	WeldTable table{ m_vertices, cornerCount };
+
+	std::map<Int16, DynamicArray<UInt32>> materialIndices;
+
+
+	for (const auto& face : data.faces)
+	{
+		if (face.vertexIndices[0] >= data.vertices.size() || face.vertexIndices[1] >= data.vertices.size() || face.vertexIndices[2] >= data.vertices.size())
+		{
+			continue;
+		}
+
+
+		auto& indices = materialIndices[face.textureIndex];
+
+		for (Index i = 0; i < 3ULL; ++i)
+		{
+			const UInt32 sourceIndex = face.vertexIndices[i];
+
+			const auto [found, slot] = table.find(sourceIndex, face.textureU[i], face.textureV[i]);
+
+			if (!WeldTable::isEmpty(found))
+			{
+				indices.push_back(found);
+
+				continue;
+			}
+
+
+			const auto& source = data.vertices[sourceIndex];
+
+			const auto  vertex = static_cast<UInt32>(m_vertices.size());
+
+			m_vertices.push_back({ source.position, source.normal, face.textureU[i], face.textureV[i], sourceIndex });
+
+			table.insert(slot, vertex);
+
+			indices.push_back(vertex);
+		}
+	}
+
+
+	m_primitives.reserve(materialIndices.size());
+
+	for (auto& [textureIndex, indices] : materialIndices)
+	{
+		m_primitives.push_back({ textureIndex, std::move(indices) });
+	}
+}
+
+/// Forsyth's scoring, tuned for a 32-entry LRU model of the post-transform cache
+namespace VertexCache
+{
+	constexpr Int32   CacheSize         = 32;
+
+	constexpr Float32 CacheDecayPower   = 1.5f;
+
+	constexpr Float32 LastTriangleScore = 0.75f;
+
+	constexpr Float32 ValenceBoostScale = 2.0f;
+
+	constexpr Float32 ValenceBoostPower = 0.5f;
+
+
+	/// Scores for every cache position (-1 = not cached) and remaining valence, precomputed once
+	struct ScoreTable final
+	{
+		Array<Float32, CacheSize + 1> position{};
+
+		Array<Float32, 64>            valence{};
+
+		ScoreTable()
+		{
+			position[0] = 0.0f;
+
+			for (Int32 i = 0; i < CacheSize; ++i)
+			{
+				position[i + 1] = (i < 3) ? LastTriangleScore : std::pow(1.0f - static_cast<Float32>(i - 3) / static_cast<Float32>(CacheSize - 3), CacheDecayPower);
+			}
+
+			for (Size i = 1; i < valence.size(); ++i)
+			{
+				valence[i] = ValenceBoostScale * std::pow(static_cast<Float32>(i), -ValenceBoostPower);
+			}
+		}
+	};
+
+	const ScoreTable Scores;
+
+
+	Float32 Score(Int32 cachePosition, UInt32 remainingValence)
+	{
+		if (remainingValence == 0U)
+		{
+			return -1.0f;
+		}
+
+		return Scores.position[cachePosition + 1] + Scores.valence[std::min<Size>(remainingValence, Scores.valence.size() - 1ULL)];
+	}
+}
+
+
+Void RenderMesh::optimize()
+{
+	for (auto& primitive : m_primitives)
+	{
+		optimizeVertexCache(primitive.indices);
+
+		optimizeOverdraw(primitive.indices);
+	}
+
+	optimizeVertexFetch();
+}
+
+
+Void RenderMesh::optimizeVertexCache(DynamicArray<UInt32>& indices) const
+{
+	using namespace VertexCache;
+
+	const Size triangleCount = indices.size() / 3ULL;
+
+	const Size vertexCount   = m_vertices.size();
+
+	if (triangleCount < 2ULL)
+	{
+		return;
+	}
+
+
+	// Triangle adjacency per vertex, packed into one array
+	DynamicArray<UInt32> valence(vertexCount, 0U);
+
+	for (const UInt32 index : indices)
+	{
+		++valence[index];
+	}
+
+	DynamicArray<UInt32> adjacencyOffset(vertexCount + 1ULL, 0U);
+
+	for (Index v = 0; v < vertexCount; ++v)
+	{
+		adjacencyOffset[v + 1ULL] = adjacencyOffset[v] + valence[v];
+	}
+
+	DynamicArray<UInt32> adjacency(indices.size());
+
+	DynamicArray<UInt32> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+
+	for (Index t = 0; t < triangleCount; ++t)
+	{
+		for (Index c = 0; c < 3ULL; ++c)
+		{
+			adjacency[fill[indices[t * 3ULL + c]]++] = static_cast<UInt32>(t);
+		}
+	}
+
+
+	DynamicArray<Int32>   cachePosition(vertexCount, -1);
+
+	DynamicArray<Float32> vertexScore(vertexCount, 0.0f);
+
+	DynamicArray<Float32> triangleScore(triangleCount, 0.0f);
+
+	DynamicArray<Bool>    emitted(triangleCount, false);
+
+	for (Index v = 0; v < vertexCount; ++v)
+	{
+		vertexScore[v] = Score(-1, valence[v]);
+	}
+
+	for (Index t = 0; t < triangleCount; ++t)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3ULL]] + vertexScore[indices[t * 3ULL + 1ULL]] + vertexScore[indices[t * 3ULL + 2ULL]];
+	}
+
+
+	DynamicArray<UInt32> output;
+
+	output.reserve(indices.size());
+
+	// Three slots of headroom: a new triangle pushes its corners in front before the tail is dropped
+	Array<UInt32, CacheSize + 3> cache{};
+
+	Array<UInt32, CacheSize + 3> nextCache{};
+
+	Size cacheCount = 0ULL;
+
+	Size bestTriangle = static_cast<Size>(std::ranges::max_element(triangleScore) - triangleScore.begin());
+
+	Size scanCursor   = 0ULL;
+
+
+	while (output.size() < indices.size())
+	{
+		emitted[bestTriangle] = true;
+
+		const Array<UInt32, 3> corners = { indices[bestTriangle * 3ULL], indices[bestTriangle * 3ULL + 1ULL], indices[bestTriangle * 3ULL + 2ULL] };
+
+		Size nextCount = 0ULL;
+
+		for (const UInt32 v : corners)
+		{
+			output.push_back(v);
+
+			nextCache[nextCount++] = v;
+
+
+			// Drop the triangle from the vertex's live adjacency
+			const UInt32 begin = adjacencyOffset[v];
+
+			const UInt32 end   = begin + valence[v];
+
+			for (UInt32 k = begin; k < end; ++k)
+			{
+				if (adjacency[k] == bestTriangle)
+				{
+					std::swap(adjacency[k], adjacency[end - 1U]);
+
+					break;
+				}
+			}
+
+			--valence[v];
+		}
+
+		for (Size i = 0; i < cacheCount; ++i)
+		{
+			if (const UInt32 v = cache[i]; v != corners[0] && v != corners[1] && v != corners[2])
+			{
+				nextCache[nextCount++] = v;
+			}
+		}
+
+		std::swap(cache, nextCache);
+
+		cacheCount = nextCount;
+
+
+		// Rescore everything that moved in or out of the cache, and the live triangles around it
+		Float32 bestScore = -1.0f;
+
+		for (Size i = 0; i < cacheCount; ++i)
+		{
+			const UInt32 v        = cache[i];
+
+			const Int32  position = (i < static_cast<Size>(CacheSize)) ? static_cast<Int32>(i) : -1;
+
+			cachePosition[v] = position;
+
+			const Float32 delta = Score(position, valence[v]) - vertexScore[v];
+
+			vertexScore[v] += delta;
+
+
+			for (UInt32 k = adjacencyOffset[v], end = adjacencyOffset[v] + valence[v]; k < end; ++k)
+			{
+				const UInt32 t = adjacency[k];
+
+				triangleScore[t] += delta;
+
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore    = triangleScore[t];
+
+					bestTriangle = t;
+				}
+			}
+		}
+
+		cacheCount = std::min<Size>(cacheCount, static_cast<Size>(CacheSize));
+
+
+		if (bestScore < 0.0f && output.size() < indices.size())
+		{
+			// Nothing cached has work left, continue with the next untouched triangle in input order
+			while (emitted[scanCursor])
+			{
+				++scanCursor;
+			}
+
+			bestTriangle = scanCursor;
+		}
+	}
+
+	indices = std::move(output);
+}
+
+
+Void RenderMesh::optimizeOverdraw(DynamicArray<UInt32>& indices) const
+{
+	// Cluster boundaries sit where the cache-ordered stream restarts cold (all three corners miss a 16-entry FIFO),
+	// so moving whole clusters around costs almost no cache efficiency
+	constexpr Size CacheSize = 16ULL;
+
+	const Size triangleCount = indices.size() / 3ULL;
+
+	if (triangleCount < 2ULL)
+	{
+		return;
+	}
+
+
+	DynamicArray<Size> clusterStart;
+
+	{
+		DynamicArray<Size> cacheTime(m_vertices.size(), 0ULL);
+
+		Size time = CacheSize + 1ULL;
+
+		for (Index t = 0; t < triangleCount; ++t)
+		{
+			Size misses = 0ULL;
+
+			for (Index c = 0; c < 3ULL; ++c)
+			{
+				if (const UInt32 v = indices[t * 3ULL + c]; time - cacheTime[v] > CacheSize)
+				{
+					cacheTime[v] = time++;
+
+					++misses;
+				}
+			}
+
+			if (misses == 3ULL || t == 0ULL)
+			{
+				clusterStart.push_back(t);
+			}
+		}
+
+		clusterStart.push_back(triangleCount);
+	}
+
+	const Size clusterCount = clusterStart.size() - 1ULL;
+
+	if (clusterCount < 2ULL)
+	{
+		return;
+	}
+
+
+	// Occlusion potential: clusters far out from the mesh centre and facing away from it are drawn first
+	auto corner = [this, &indices](Index t, Index c) -> const Vector3D&
+	{
+		return m_vertices[indices[t * 3ULL + c]].position;
+	};
+
+	Array<Float64, 3> meshCentroid{};
+
+	Float64           meshArea = 0.0;
+
+	DynamicArray<Array<Float64, 3>> centroids(clusterCount);
+
+	DynamicArray<Array<Float64, 3>> normals(clusterCount);
+
+	DynamicArray<Float64>           areas(clusterCount, 0.0);
+
+	for (Index k = 0; k < clusterCount; ++k)
+	{
+		for (Index t = clusterStart[k]; t < clusterStart[k + 1ULL]; ++t)
+		{
+			const Vector3D& a = corner(t, 0ULL);
+			const Vector3D& b = corner(t, 1ULL);
+			const Vector3D& c = corner(t, 2ULL);
+
+			const Array<Float64, 3> e1 = { b.x - a.x, b.y - a.y, b.z - a.z };
+			const Array<Float64, 3> e2 = { c.x - a.x, c.y - a.y, c.z - a.z };
+
+			const Array<Float64, 3> n  = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+			const Float64 area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			const Array<Float64, 3> centre = { (a.x + b.x + c.x) / 3.0, (a.y + b.y + c.y) / 3.0, (a.z + b.z + c.z) / 3.0 };
+
+			for (Index i = 0; i < 3ULL; ++i)
+			{
+				centroids[k][i] += centre[i] * area;
+
+				normals[k][i]   += n[i];
+
+				meshCentroid[i] += centre[i] * area;
+			}
+
+			areas[k] += area;
+
+			meshArea += area;
+		}
+	}
+
+	if (meshArea <= 0.0)
+	{
+		return;
+	}
+
+	for (auto& value : meshCentroid)
+	{
+		value /= meshArea;
+	}
+
+
+	DynamicArray<Float64> potential(clusterCount, 0.0);
+
+	for (Index k = 0; k < clusterCount; ++k)
+	{
+		if (areas[k] <= 0.0)
+		{
+			continue;
+		}
+
+		const Float64 length = std::sqrt(normals[k][0] * normals[k][0] + normals[k][1] * normals[k][1] + normals[k][2] * normals[k][2]);
+
+		if (length <= 0.0)
+		{
+			continue;
+		}
+
+		for (Index i = 0; i < 3ULL; ++i)
+		{
+			potential[k] += (centroids[k][i] / areas[k] - meshCentroid[i]) * normals[k][i] / length;
+		}
+	}
+
+
+	DynamicArray<Size> order(clusterCount);
+
+	std::iota(order.begin(), order.end(), 0ULL);
+
+	std::ranges::stable_sort(order, [&potential](Size left, Size right) { return potential[left] > potential[right]; });
+
+
+	DynamicArray<UInt32> output;
+
+	output.reserve(indices.size());
+
+	for (const Size k : order)
+	{
+		output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[k] * 3ULL), indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[k + 1ULL] * 3ULL));
+	}
+
+	indices = std::move(output);
+}
+
+
+Void RenderMesh::optimizeVertexFetch()
+{
+	constexpr UInt32 Unassigned = 0xFFFFFFFFU;
+
+	DynamicArray<UInt32> remap(m_vertices.size(), Unassigned);
+
+	DynamicArray<RenderVertex> vertices;
+
+	vertices.reserve(m_vertices.size());
+
+	// Vertices are laid out in the order the GPU first reads them
+	for (auto& primitive : m_primitives)
+	{
+		for (auto& index : primitive.indices)
+		{
+			if (remap[index] == Unassigned)
+			{
+				remap[index] = static_cast<UInt32>(vertices.size());
+
+				vertices.push_back(m_vertices[index]);
+			}
+
+			index = remap[index];
+		}
+	}
+
+	m_vertices = std::move(vertices);
+}
\ No newline at end of file
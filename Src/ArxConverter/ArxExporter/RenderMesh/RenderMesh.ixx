@@ -0,0 +1,69 @@
+module;
+
+export module ArxConverter.RenderMesh;
+
+
+import ArxConverter.Container;
+import ArxConverter.ArxHeaders;
+
+
+/// One GPU vertex: FTL stores UVs per face corner, so a source vertex is split once per distinct UV it is used with
+export struct RenderVertex final
+{
+	Vector3D position    = {};
+
+	Vector3D normal      = {};
+
+	Float32  u           = 0.0f;
+
+	Float32  v           = 0.0f;
+
+	UInt32   sourceIndex = 0U; ///< Index into FtlFileData::vertices
+};
+
+/// Triangle list of the faces sharing one texture
+export struct RenderPrimitive final
+{
+	Int16                textureIndex = -1;
+
+	DynamicArray<UInt32> indices      = {};
+};
+
+
+/// Welded, indexed triangle mesh built from the faces of an FTL model, ready for the GPU-oriented writers
+export class RenderMesh final
+{
+	DynamicArray<RenderVertex>    m_vertices;
+
+	DynamicArray<RenderPrimitive> m_primitives; ///< Ascending textureIndex, faces keep their file order
+
+public:
+
+	RenderMesh() = delete;
+
+   ~RenderMesh() = default;
+
+
+	/// Faces referencing vertices outside the vertex array are dropped
+	explicit RenderMesh(const FtlFileData& data);
+
+
+	/// Reorders each primitive's triangles for the post-transform vertex cache (Forsyth), then sorts cache-friendly
+	/// clusters of them to reduce overdraw, and finally renumbers vertices in first-use order for fetch locality
+	Void optimize();
+
+
+	[[nodiscard]] const DynamicArray<RenderVertex>&    getVertices()   const noexcept;
+
+	[[nodiscard]] const DynamicArray<RenderPrimitive>& getPrimitives() const noexcept;
+
+private:
+
+	Void weld(const FtlFileData& data);
+
+	Void optimizeVertexCache(DynamicArray<UInt32>& indices) const;
+
+	Void optimizeOverdraw(DynamicArray<UInt32>& indices) const;
+
+	Void optimizeVertexFetch();
+};
\ No newline at end of file
@@ -0,0 +1,218 @@
+module;
+
+#include <ostream>
+#include <charconv>
+#include <stdexcept>
+
+module ArxConverter.XmlWriter;
+
+
+XmlWriter::XmlWriter(std::ostream& stream) noexcept : m_stream{ stream }
+{
+
+}
+
+
+XmlWriter::~XmlWriter()
+{
+	flush();
+}
+
+
+Void XmlWriter::openElement(StringView name)
+{
+	if (m_depth == MaxDepth)
+	{
+		throw std::runtime_error("XmlWriter: nesting deeper than 32 levels");
+	}
+
+	sealElement();
+
+	// Every element starts on its own line unless it sits inside text
+	if (!m_firstElement && m_textDepth < 0)
+	{
+		put('\n');
+	}
+
+	if (m_firstElement || m_textDepth < 0)
+	{
+		for (Size i = 0; i < m_depth; ++i)
+		{
+			put("    ");
+		}
+	}
+
+	m_firstElement = false;
+
+
+	m_names[m_depth++] = name;
+
+	put('<');
+
+	put(name);
+
+	m_justOpened = true;
+}
+
+
+Void XmlWriter::closeElement()
+{
+	if (m_depth == 0ULL)
+	{
+		throw std::runtime_error("XmlWriter: closeElement() without an open element");
+	}
+
+	const StringView name = m_names[--m_depth];
+
+	if (m_justOpened)
+	{
+		put("/>");
+	}
+	else
+	{
+		if (m_textDepth < 0)
+		{
+			put('\n');
+
+			for (Size i = 0; i < m_depth; ++i)
+			{
+				put("    ");
+			}
+		}
+
+		put("</");
+
+		put(name);
+
+		put('>');
+	}
+
+
+	if (m_textDepth == static_cast<Int64>(m_depth))
+	{
+		m_textDepth = -1;
+	}
+
+	if (m_depth == 0ULL)
+	{
+		put('\n');
+	}
+
+	m_justOpened = false;
+}
+
+
+Void XmlWriter::attribute(StringView name, StringView value)
+{
+	put(' ');
+
+	put(name);
+
+	put("=\"");
+
+	putEscaped(value, true);
+
+	put('"');
+}
+
+
+Void XmlWriter::attribute(StringView name, Float32 value)
+{
+	put(' ');
+
+	put(name);
+
+	put("=\"");
+
+	reserve(32ULL);
+
+	m_used = static_cast<Size>(std::to_chars(m_buffer.data() + m_used, m_buffer.data() + BufferSize, static_cast<Float64>(value), std::chars_format::general, 8).ptr - m_buffer.data());
+
+	put('"');
+}
+
+
+Void XmlWriter::text(StringView text)
+{
+	m_textDepth = static_cast<Int64>(m_depth) - 1;
+
+	sealElement();
+
+	putEscaped(text, false);
+}
+
+
+Void XmlWriter::flush()
+{
+	m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+
+	m_used = 0ULL;
+}
+
+
+Void XmlWriter::sealElement()
+{
+	if (m_justOpened)
+	{
+		m_justOpened = false;
+
+		put('>');
+	}
+}
+
+
+Void XmlWriter::reserve(Size bytes)
+{
+	if (m_used + bytes > BufferSize)
+	{
+		flush();
+	}
+}
+
+
+Void XmlWriter::put(Char8 character)
+{
+	reserve(1ULL);
+
+	m_buffer[m_used++] = character;
+}
+
+
+Void XmlWriter::put(StringView text)
+{
+	if (text.size() > BufferSize)
+	{
+		flush();
+
+		m_stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+		return;
+	}
+
+	reserve(text.size());
+
+	for (const Char8 character : text)
+	{
+		m_buffer[m_used++] = character;
+	}
+}
+
+
+/// Attributes escape quotes too, text only needs & < >
+Void XmlWriter::putEscaped(StringView text, Bool isAttribute)
+{
+	for (const Char8 character : text)
+	{
+		switch (character)
+		{
+			case '&': put("&amp;"); break;
+			case '<': put("&lt;");  break;
+			case '>': put("&gt;");  break;
+
+			case '"':  isAttribute ? put("&quot;") : put(character); break;
+			case '\'': isAttribute ? put("&apos;") : put(character); break;
+
+			default: put(character);
+		}
+	}
+}
\ No newline at end of file
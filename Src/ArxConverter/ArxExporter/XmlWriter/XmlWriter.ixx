@@ -0,0 +1,140 @@
+module;
+
+#include <ostream>
+#include <charconv>
+#include <concepts>
+#include <ranges>
+
+export module ArxConverter.XmlWriter;
+
+
+import ArxConverter.Container;
+
+
+/// Forward-only XML emitter writing straight into a fixed buffer, formatted like tinyxml2's XMLPrinter
+export class XmlWriter final
+{
+	static constexpr Size BufferSize = 0x10000ULL;
+
+	static constexpr Size MaxDepth   = 32ULL;
+
+
+	std::ostream& m_stream;
+
+
+	Array<Char8, BufferSize> m_buffer;
+
+	Size                     m_used = 0ULL;
+
+
+	Array<StringView, MaxDepth> m_names;
+
+	Size  m_depth         = 0ULL;
+
+	Int64 m_textDepth     = -1;    ///< Depth of the element holding text, which stays on its line
+
+	Bool  m_justOpened    = false; ///< Start tag still open for attributes
+
+	Bool  m_firstElement  = true;
+
+public:
+
+	XmlWriter() = delete;
+
+   ~XmlWriter();
+
+
+	explicit XmlWriter(std::ostream& stream) noexcept;
+
+
+	XmlWriter(const XmlWriter&) = delete;
+
+	XmlWriter& operator=(const XmlWriter&) = delete;
+
+
+	/// name must outlive the matching closeElement(). Throws past MaxDepth nested elements
+	Void openElement(StringView name);
+
+	/// Throws when no element is open
+	Void closeElement();
+
+
+	Void attribute(StringView name, StringView value);
+
+	/// "%.8g", the precision tinyxml2 gives float attributes
+	Void attribute(StringView name, Float32 value);
+
+	template<std::integral Integer>
+	Void attribute(StringView name, Integer value);
+
+
+	Void text(StringView text);
+
+	/// Space-separated list of numbers as the element's text
+	template<std::ranges::input_range Range>
+	Void text(const Range& values);
+
+
+	/// Hands everything buffered so far to the stream
+	Void flush();
+
+private:
+
+	Void sealElement();
+
+	Void reserve(Size bytes);
+
+	Void put(Char8 character);
+
+	Void put(StringView text);
+
+	Void putEscaped(StringView text, Bool isAttribute);
+
+	template<std::integral Integer>
+	Void putNumber(Integer value);
+};
+
+
+template<std::integral Integer>
+Void XmlWriter::attribute(StringView name, Integer value)
+{
+	put(' ');
+
+	put(name);
+
+	put("=\"");
+
+	putNumber(value);
+
+	put('"');
+}
+
+
+template<std::ranges::input_range Range>
+Void XmlWriter::text(const Range& values)
+{
+	text(StringView{});
+
+	Bool first = true;
+
+	for (const auto value : values)
+	{
+		if (!first)
+		{
+			put(' ');
+		}
+
+		putNumber(value);
+
+		first = false;
+	}
+}
+
+
+template<std::integral Integer>
+Void XmlWriter::putNumber(Integer value)
+{
+	reserve(24ULL);
+
+	m_used = static_cast<Size>(std::to_chars(m_buffer.data() + m_used, m_buffer.data() + BufferSize, value).ptr - m_buffer.data());
+}
\ No newline at end of file
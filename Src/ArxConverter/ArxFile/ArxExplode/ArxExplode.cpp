@@ -1,6 +1,8 @@
 module;
 
+#include <bit>
 #include <span>
+#include <cstring>
 #include <utility>
 #include <algorithm>
 
@@ -23,118 +25,125 @@ module;
 module ArxConverter.ArxExplode;
 
 
+import ArxConverter.ArxTables;
+
+
 namespace Tables
 {
-	constexpr Array<UInt8, 0x40> DistBits =
-	{{
-		0x02, 0x04, 0x04, 0x05, 0x05, 0x05, 0x05, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
-		0x06, 0x06, 0x06, 0x06, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
-		0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
-		0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08
-	}};
-
-	constexpr Array<UInt8, 0x40> DistCode =
-	{{
-		0x03, 0x0D, 0x05, 0x19, 0x09, 0x11, 0x01, 0x3E, 0x1E, 0x2E, 0x0E, 0x36, 0x16, 0x26, 0x06, 0x3A, 0x1A, 0x2A,
-		0x0A, 0x32, 0x12, 0x22, 0x42, 0x02, 0x7C, 0x3C, 0x5C, 0x1C, 0x6C, 0x2C, 0x4C, 0x0C, 0x74, 0x34, 0x54, 0x14,
-		0x64, 0x24, 0x44, 0x04, 0x78, 0x38, 0x58, 0x18, 0x68, 0x28, 0x48, 0x08, 0xF0, 0x70, 0xB0, 0x30, 0xD0, 0x50,
-		0x90, 0x10, 0xE0, 0x60, 0xA0, 0x20, 0xC0, 0x40, 0x80, 0x00
-	}};
-
-	constexpr Array<UInt8, 0x10> ExLenBits =
-	{{
-		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08
-	}};
-
-	constexpr Array<UInt16, 0x10> LenBase =
-	{{
-		0x0000, 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x000A, 0x000E, 0x0016, 0x0026, 0x0046, 0x0086, 0x0106
-	}};
-
-	constexpr Array<UInt8, 0x10> LenBits =
-	{{
-		0x03, 0x02, 0x03, 0x03, 0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x05, 0x06, 0x06, 0x06, 0x07, 0x07
-	}};
-
-	constexpr Array<UInt8, 0x10> LenCode =
-	{{
-		0x05, 0x03, 0x01, 0x06, 0x0A, 0x02, 0x0C, 0x14, 0x04, 0x18, 0x08, 0x30, 0x10, 0x20, 0x40, 0x00
-	}};
-
-	constexpr Array<UInt8, 0x100> ChBitsAsc =
-	{{
-		0x0B, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x08, 0x07, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x0C, 0x0C,
-		0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0D, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x04, 0x0A, 0x08, 0x0C,
-		0x0A, 0x0C, 0x0A, 0x08, 0x07, 0x07, 0x08, 0x09, 0x07, 0x06, 0x07, 0x08, 0x07, 0x06, 0x07, 0x07, 0x07, 0x07,
-		0x08, 0x07, 0x07, 0x08, 0x08, 0x0C, 0x0B, 0x07, 0x09, 0x0B, 0x0C, 0x06, 0x07, 0x06, 0x06, 0x05, 0x07, 0x08,
-		0x08, 0x06, 0x0B, 0x09, 0x06, 0x07, 0x06, 0x06, 0x07, 0x0B, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x09, 0x09,
-		0x0B, 0x08, 0x0B, 0x09, 0x0C, 0x08, 0x0C, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x0B, 0x07,
-		0x05, 0x06, 0x05, 0x05, 0x06, 0x0A, 0x05, 0x05, 0x05, 0x05, 0x08, 0x07, 0x08, 0x08, 0x0A, 0x0B, 0x0B, 0x0C,
-		0x0C, 0x0C, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D,
-		0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D,
-		0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0C, 0x0C, 0x0C, 0x0C,
-		0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C,
-		0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C,
-		0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0D, 0x0C, 0x0D, 0x0D, 0x0D, 0x0C, 0x0D, 0x0D, 0x0D, 0x0C,
-		0x0D, 0x0D, 0x0D, 0x0D, 0x0C, 0x0D, 0x0D, 0x0D, 0x0C, 0x0C, 0x0C, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D,
-		0x0D, 0x0D, 0x0D, 0x0D
-	}};
-
-	constexpr Array<UInt16, 0x100> ChCodeAsc =
-	{{
-		0x0490, 0x0FE0, 0x07E0, 0x0BE0, 0x03E0, 0x0DE0, 0x05E0, 0x09E0, 0x01E0, 0x00B8, 0x0062, 0x0EE0, 0x06E0,
-		0x0022, 0x0AE0, 0x02E0, 0x0CE0, 0x04E0, 0x08E0, 0x00E0, 0x0F60, 0x0760, 0x0B60, 0x0360, 0x0D60, 0x0560,
-		0x1240, 0x0960, 0x0160, 0x0E60, 0x0660, 0x0A60, 0x000F, 0x0250, 0x0038, 0x0260, 0x0050, 0x0C60, 0x0390,
-		0x00D8, 0x0042, 0x0002, 0x0058, 0x01B0, 0x007C, 0x0029, 0x003C, 0x0098, 0x005C, 0x0009, 0x001C, 0x006C,
-		0x002C, 0x004C, 0x0018, 0x000C, 0x0074, 0x00E8, 0x0068, 0x0460, 0x0090, 0x0034, 0x00B0, 0x0710, 0x0860,
-		0x0031, 0x0054, 0x0011, 0x0021, 0x0017, 0x0014, 0x00A8, 0x0028, 0x0001, 0x0310, 0x0130, 0x003E, 0x0064,
-		0x001E, 0x002E, 0x0024, 0x0510, 0x000E, 0x0036, 0x0016, 0x0044, 0x0030, 0x00C8, 0x01D0, 0x00D0, 0x0110,
-		0x0048, 0x0610, 0x0150, 0x0060, 0x0088, 0x0FA0, 0x0007, 0x0026, 0x0006, 0x003A, 0x001B, 0x001A, 0x002A,
-		0x000A, 0x000B, 0x0210, 0x0004, 0x0013, 0x0032, 0x0003, 0x001D, 0x0012, 0x0190, 0x000D, 0x0015, 0x0005,
-		0x0019, 0x0008, 0x0078, 0x00F0, 0x0070, 0x0290, 0x0410, 0x0010, 0x07A0, 0x0BA0, 0x03A0, 0x0240, 0x1C40,
-		0x0C40, 0x1440, 0x0440, 0x1840, 0x0840, 0x1040, 0x0040, 0x1F80, 0x0F80, 0x1780, 0x0780, 0x1B80, 0x0B80,
-		0x1380, 0x0380, 0x1D80, 0x0D80, 0x1580, 0x0580, 0x1980, 0x0980, 0x1180, 0x0180, 0x1E80, 0x0E80, 0x1680,
-		0x0680, 0x1A80, 0x0A80, 0x1280, 0x0280, 0x1C80, 0x0C80, 0x1480, 0x0480, 0x1880, 0x0880, 0x1080, 0x0080,
-		0x1F00, 0x0F00, 0x1700, 0x0700, 0x1B00, 0x0B00, 0x1300, 0x0DA0, 0x05A0, 0x09A0, 0x01A0, 0x0EA0, 0x06A0,
-		0x0AA0, 0x02A0, 0x0CA0, 0x04A0, 0x08A0, 0x00A0, 0x0F20, 0x0720, 0x0B20, 0x0320, 0x0D20, 0x0520, 0x0920,
-		0x0120, 0x0E20, 0x0620, 0x0A20, 0x0220, 0x0C20, 0x0420, 0x0820, 0x0020, 0x0FC0, 0x07C0, 0x0BC0, 0x03C0,
-		0x0DC0, 0x05C0, 0x09C0, 0x01C0, 0x0EC0, 0x06C0, 0x0AC0, 0x02C0, 0x0CC0, 0x04C0, 0x08C0, 0x00C0, 0x0F40,
-		0x0740, 0x0B40, 0x0340, 0x0300, 0x0D40, 0x1D00, 0x0D00, 0x1500, 0x0540, 0x0500, 0x1900, 0x0900, 0x0940,
-		0x1100, 0x0100, 0x1E00, 0x0E00, 0x0140, 0x1600, 0x0600, 0x1A00, 0x0E40, 0x0640, 0x0A40, 0x0A00, 0x1200,
-		0x0200, 0x1C00, 0x0C00, 0x1400, 0x0400, 0x1800, 0x0800, 0x1000, 0x0000
-	}};
+	/// Builds a decode table for an LSB-first prefix code: every index whose low bits match a code maps to that code's entry
+	template<typename Entry, Size tableSize, typename Code, Size codeCount, typename MakeEntry>
+	consteval Array<Entry, tableSize> BuildDecodeTable(const Array<Code, codeCount>& codes, const Array<UInt8, codeCount>& bits, MakeEntry makeEntry)
+	{
+		Array<Entry, tableSize> table{};
+
+		for (Index symbol = 0; symbol < codeCount; ++symbol)
+		{
+			const Entry entry = makeEntry(symbol);
+
+			for (Index index = codes[symbol]; index < tableSize; index += 1ULL << bits[symbol])
+			{
+				table[index] = entry;
+			}
+		}
+
+		return table;
+	}
+
+
+	/// Resolved length code: everything needed to read a repetition length after a single lookup
+	struct LengthEntry final
+	{
+		UInt16 base      = 0U; ///< Length before the extra bits are added
+
+		UInt8  codeBits  = 0U; ///< Bits taken by the length code itself
+
+		UInt8  extraBits = 0U; ///< Raw bits following the code, added to base
+	};
+
+	/// Resolved distance position code
+	struct DistanceEntry final
+	{
+		UInt8 position = 0U; ///< High part of the distance
+
+		UInt8 codeBits = 0U; ///< Bits taken by the position code itself
+	};
+
+
+	/// Length decode table indexed by the 7 bits after the flag bit (longest length code)
+	constexpr auto LengthDecode = BuildDecodeTable<LengthEntry, 0x80>(LenCode, LenBits, [](Index code)
+	{
+		return LengthEntry{ LenBase[code], LenBits[code], ExLenBits[code] };
+	});
+
+	/// ASCII-mode literal decode table indexed by the 13 bits after the flag bit (longest literal code).
+	/// Each entry packs the literal in the low byte and its code length in the high byte.
+	constexpr auto AsciiDecode = BuildDecodeTable<UInt16, 0x2000>(ChCodeAsc, ChBitsAsc, [](Index literal)
+	{
+		return static_cast<UInt16>(literal | (ChBitsAsc[literal] << 8U));
+	});
+
+	/// Distance position decode table indexed by the next 8 bits (longest position code)
+	constexpr auto DistanceDecode = BuildDecodeTable<DistanceEntry, 0x100>(DistCode, DistBits, [](Index position)
+	{
+		return DistanceEntry{ static_cast<UInt8>(position), DistBits[position] };
+	});
 }
 
 
-FORCE_INLINE Bool WasteBits(ArxExplode::State& state, UInt32 nBits) noexcept
+FORCE_INLINE UInt64 LoadLE64(const Byte* ptr) noexcept
 {
-	if (nBits <= state.extra_bits)
-	{
-		state.extra_bits -= nBits;
+	UInt64 value;
 
-		state.bit_buff  >>= nBits;
+	std::memcpy(&value, ptr, sizeof(value));
 
 
-		return true;
+	if constexpr (std::endian::native == std::endian::big)
+	{
+		value = std::byteswap(value);
 	}
 
+	return value;
+}
 
-	state.bit_buff >>= state.extra_bits;
+
+/// Tops the accumulator up to at least 56 bits.
+/// Uses a single unaligned 8-byte load while 8 input bytes remain, bytewise bounds-checked reads near the end.
+FORCE_INLINE Void Refill(ArxExplode::State& state) noexcept
+{
+	if (state.inputEnd - state.inputPtr >= 8) [[likely]]
+	{
+		state.bit_buff  |= LoadLE64(state.inputPtr) << state.bit_count;
+
+		state.inputPtr  += (63U - state.bit_count) >> 3U;
+
+		state.bit_count |= 56U;
+
+
+		return;
+	}
 
 
-	if (state.inputPtr < state.inputEnd)
+	while (state.bit_count <= 56U && state.inputPtr < state.inputEnd)
 	{
-		state.bit_buff |= static_cast<UInt32>(static_cast<UInt8>(*state.inputPtr++)) << 8U;
+		state.bit_buff  |= static_cast<UInt64>(static_cast<UInt8>(*state.inputPtr++)) << state.bit_count;
+
+		state.bit_count += 8U;
 	}
-	else
+}
+
+
+/// Drops nBits from the accumulator. Fails only when the input holds fewer bits than requested.
+FORCE_INLINE Bool WasteBits(ArxExplode::State& state, UInt32 nBits) noexcept
+{
+	if (nBits > state.bit_count) [[unlikely]]
 	{
 		return false;
 	}
 
 
-	state.bit_buff >>= (nBits - state.extra_bits);
+	state.bit_buff  >>= nBits;
 
-	state.extra_bits = (state.extra_bits - nBits) + 8U;
+	state.bit_count  -= nBits;
 
 
 	return true;
@@ -143,172 +152,326 @@ FORCE_INLINE Bool WasteBits(ArxExplode::State& state, UInt32 nBits) noexcept
 
 FORCE_INLINE UInt32 DecodeLit(ArxExplode::State& state) noexcept
 {
+	// The flag bit is consumed together with the code that follows it
 	if (state.bit_buff & 1U)
 	{
-		if (!WasteBits(state, 1U))
-		{
-			return 0x306U;
-		}
+		const auto [base, codeBits, extraBits] = Tables::LengthDecode[(state.bit_buff >> 1U) & 0x7FU];
 
 
-		const UInt32 lengthCode = state.LengthCodes[state.bit_buff & 0xFFU];
+		const UInt32 extraLength = static_cast<UInt32>(state.bit_buff >> (1U + codeBits)) & ((1U << extraBits) - 1U);
 
 
-		if (!WasteBits(state, state.LenBits[lengthCode]))
+		if (!WasteBits(state, 1U + codeBits + extraBits))
 		{
 			return 0x306U;
 		}
 
+		return base + extraLength + 0x100U;
+	}
 
-		UInt32 finalCode = lengthCode;
 
+	if (state.type == 0U)
+	{
+		const UInt32 byteVal = static_cast<UInt32>(state.bit_buff >> 1U) & 0xFFU;
 
-		if (const UInt32 extraLenBits = state.ExLenBits[lengthCode]; extraLenBits != 0U)
+		if (!WasteBits(state, 9U))
 		{
-			const UInt32 extraLength = state.bit_buff & ((1U << extraLenBits) - 1U);
-
-			if (!WasteBits(state, extraLenBits))
-			{
-				if ((lengthCode + extraLength) != 0x10EU)
-				{
-					return 0x306U;
-				}
-			}
-
-			finalCode = state.LenBase[lengthCode] + extraLength;
+			return 0x306U;
 		}
 
-		return finalCode + 0x100U;
+		return byteVal;
 	}
 
 
-	if (!WasteBits(state, 1U))
+	const UInt16 entry = Tables::AsciiDecode[(state.bit_buff >> 1U) & 0x1FFFU];
+
+
+	if (!WasteBits(state, 1U + (entry >> 8U)))
 	{
 		return 0x306U;
 	}
 
+	return entry & 0xFFU;
+}
 
-	if (state.type == 0U)
+
+FORCE_INLINE UInt32 DecodeDist(ArxExplode::State& state, UInt32 repLength) noexcept
+{
+	const auto [position, codeBits] = Tables::DistanceDecode[state.bit_buff & 0xFFU];
+
+
+	// Two-byte repetitions always carry 2 low distance bits, longer ones carry the dictionary size bits
+	const UInt32 lowBits  = (repLength == 2U) ? 2U : state.dsize_bits;
+
+	const UInt32 distance = (static_cast<UInt32>(position) << lowBits) | (static_cast<UInt32>(state.bit_buff >> codeBits) & ((1U << lowBits) - 1U));
+
+
+	if (!WasteBits(state, codeBits + lowBits))
 	{
-		const UInt32 byteVal = state.bit_buff & 0xFFU;
+		return 0U;
+	}
+
+	return distance + 1U;
+}
+
+
+/// Bytes CopyMatch may write past the end of a match
+constexpr Size MatchSlack = 16ULL;
+
+/// Longest repetition a single length code can produce
+constexpr Size MaxMatchLength = 0x206ULL;
+
+
+/// Copies a back-reference from earlier output. May write up to MatchSlack bytes past dst + length.
+FORCE_INLINE Void CopyMatch(Byte* dst, Size distance, UInt32 length) noexcept
+{
+	const Byte* src = dst - distance;
 
-		if (!WasteBits(state, 8U))
+	const Byte* end = dst + length;
+
+
+	if (distance >= 16ULL)
+	{
+		do
 		{
-			return 0x306U;
-		}
+			std::memcpy(dst, src, 16ULL);
 
-		return byteVal;
-	}
+			dst += 16ULL;
+
+			src += 16ULL;
 
+		} while (dst < end);
+	}
+	else if (distance >= 8ULL)
+	{
+		do
+		{
+			std::memcpy(dst, src, 8ULL);
 
-	UInt32 value = 0U;
+			dst += 8ULL;
 
+			src += 8ULL;
 
-	if (const UInt32 lowByte = state.bit_buff & 0xFFU)
+		} while (dst < end);
+	}
+	else if (distance == 1ULL)
+	{
+		std::memset(dst, static_cast<Int32>(*src), length);
+	}
+	else if (distance == 2ULL)
 	{
-		value = state.Offs2C34[lowByte];
+		UInt16 pair;
+
+		std::memcpy(&pair, src, sizeof(pair));
+
 
-		if (value == 0xFFU)
+		const UInt64 pattern = pair * 0x0001000100010001ULL;
+
+		do
 		{
-			if (state.bit_buff & 0x3FU)
-			{
-				if (!WasteBits(state, 4U))
-				{
-					return 0x306U;
-				}
+			std::memcpy(dst, &pattern, sizeof(pattern));
 
-				value = state.Offs2D34[state.bit_buff & 0xFFU];
-			}
-			else
-			{
-				if (!WasteBits(state, 6U))
-				{
-					return 0x306U;
-				}
+			dst += sizeof(pattern);
 
-				value = state.Offs2E34[state.bit_buff & 0x7FU];
-			}
-		}
+		} while (dst < end);
 	}
 	else
 	{
-		if (!WasteBits(state, 8U))
+		for (UInt32 i = 0; i < length; ++i)
 		{
-			return 0x306U;
+			dst[i] = src[i];
 		}
-
-		value = state.Offs2EB4[state.bit_buff & 0xFFU];
 	}
+}
+
+
+/// Decoder destination: a fixed caller buffer, or a growable array when storage is set
+struct OutputBuffer final
+{
+	Byte* data     = nullptr;
 
+	Size  capacity = 0ULL;
 
-	if (!WasteBits(state, state.ChBitsAsc[value]))
+
+	UninitializedArray<Byte>* storage = nullptr;
+
+
+	/// Grows geometrically to at least required bytes; uninitialized, so only the kept bytes are copied on reallocation
+	Bool grow(Size required)
 	{
-		return 0x306U;
+		if (storage == nullptr)
+		{
+			return false;
+		}
+
+
+		storage->resize(std::max<Size>(capacity * 2ULL, required));
+
+		data     = storage->data();
+
+		capacity = storage->size();
+
+
+		return true;
 	}
+};
 
-	return value;
-}
 
+enum class DecodeStatus : UInt8
+{
+	Done       = 0U,
+	Corrupt    = 1U,
+	OutputFull = 2U
+};
 
-FORCE_INLINE UInt32 DecodeDist(ArxExplode::State& state, UInt32 repLength) noexcept
+
+/// Takes state and output by value: the output is std::byte, so stores through it would otherwise force reloads of both
+DecodeStatus DecodeStream(ArxExplode::State state, OutputBuffer output, Size& written)
 {
-	const UInt32 distPosCode = state.DistPosCodes[state.bit_buff & 0xFFU];
+	DecodeStatus status = DecodeStatus::Done;
+
+	Size         outPos = 0ULL;
 
 
-	if (const UInt32 distPosBits = state.DistBits[distPosCode]; !WasteBits(state, distPosBits))
+	while (true)
 	{
-		return 0U;
-	}
+		// One refill covers the longest literal/length code plus its distance (30 bits)
+		Refill(state);
 
 
-	UInt32 distance = 0U;
+		const UInt32 nextLiteral = DecodeLit(state);
 
 
-	if (repLength == 2U)
-	{
-		distance = (distPosCode << 2U) | (state.bit_buff & 0x03U);
+		if (nextLiteral >= 0x305U)
+		{
+			status = (nextLiteral == 0x305U) ? DecodeStatus::Done : DecodeStatus::Corrupt;
+
+			break;
+		}
+
 
-		if (!WasteBits(state, 2U))
+		if (nextLiteral < 0x100U)
 		{
-			return 0U;
+			if (outPos == output.capacity && !output.grow(outPos + 1ULL)) [[unlikely]]
+			{
+				status = DecodeStatus::OutputFull;
+
+				break;
+			}
+
+			output.data[outPos++] = static_cast<Byte>(nextLiteral);
+
+			continue;
 		}
-	}
-	else
-	{
-		distance = (distPosCode << state.dsize_bits) | (state.bit_buff & state.dsize_mask);
 
-		if (!WasteBits(state, state.dsize_bits))
+
+		const UInt32 repLength = nextLiteral - 0xFEU;
+
+		const UInt32 minusDist = DecodeDist(state, repLength);
+
+
+		if (minusDist == 0U || minusDist > outPos)
 		{
-			return 0U;
+			status = DecodeStatus::Corrupt;
+
+			break;
 		}
+
+
+		const Size matchEnd = outPos + repLength;
+
+
+		// Matches are resolved against the output itself, CopyMatch needs slack for its wide stores
+		if (matchEnd + MatchSlack > output.capacity) [[unlikely]]
+		{
+			if (!output.grow(matchEnd + MatchSlack))
+			{
+				if (matchEnd > output.capacity)
+				{
+					status = DecodeStatus::OutputFull;
+
+					break;
+				}
+
+
+				// Tail of a fixed buffer: no room for overshoot
+				Byte*       dst = output.data + outPos;
+
+				const Byte* src = dst - minusDist;
+
+				for (UInt32 i = 0; i < repLength; ++i)
+				{
+					dst[i] = src[i];
+				}
+
+				outPos = matchEnd;
+
+				continue;
+			}
+		}
+
+
+		CopyMatch(output.data + outPos, minusDist, repLength);
+
+		outPos = matchEnd;
 	}
 
 
-	return distance + 1U;
+	written = outPos;
+
+	return status;
 }
 
 
-ArxExplode::ArxExplode(const DynamicArray<Byte>& compressed, Logger& logger) noexcept : m_compressed{ compressed }, m_logger{ logger }
+ArxExplode::ArxExplode(std::span<const Byte> compressed, Logger& logger) : m_compressed{ compressed }, m_logger{ logger }
 {
-	if (!m_compressed.empty())
-	{
-		m_decompressed.reserve(m_compressed.size() * 3ULL);
-	}
+	m_decompressed.resize(m_compressed.size() * 3ULL);
+
+	decompress();
+}
+
+
+ArxExplode::ArxExplode(std::span<const Byte> compressed, Size expectedSize, Logger& logger) : m_compressed{ compressed }, m_logger{ logger }
+{
+	m_decompressed.resize(expectedSize + MatchSlack);
 
 	decompress();
 }
 
 
-DynamicArray<Byte> ArxExplode::releaseDecompressed() noexcept
+ArxExplode::ArxExplode(std::span<const Byte> compressed, std::span<Byte> output, Logger& logger) : m_compressed{ compressed }, m_output{ output }, m_intoOutput{ true }, m_logger{ logger }
+{
+	decompress();
+}
+
+
+ArxExplode::ArxExplode(std::span<const Byte> compressed, UninitializedArray<Byte>&& recycled, Logger& logger) : m_compressed{ compressed }, m_decompressed{ std::move(recycled) }, m_logger{ logger }
+{
+	// Old contents get overwritten, resizing within the capacity neither allocates nor fills
+	m_decompressed.resize(std::max<Size>(m_decompressed.capacity(), m_compressed.size() * 3ULL));
+
+	decompress();
+}
+
+
+UninitializedArray<Byte> ArxExplode::releaseDecompressed() noexcept
 {
 	return std::move(m_decompressed);
 }
 
 
+Size ArxExplode::getDecompressedSize() const noexcept
+{
+	return m_decompressedSize;
+}
+
+
 Void ArxExplode::decompress()
 {
 	if (m_compressed.empty())
 	{
+		m_decompressed.clear();
+
 		return;
 	}
 
@@ -320,28 +483,16 @@ Void ArxExplode::decompress()
 	state.inputEnd = state.inputPtr + m_compressed.size();
 
 
-	if (state.inputPtr >= state.inputEnd)
-	{
-		return;
-	}
-
-	state.type = static_cast<UInt32>(static_cast<UInt8>(*state.inputPtr++));
-
-	if (state.inputPtr >= state.inputEnd)
+	if (state.inputEnd - state.inputPtr < 3)
 	{
-		return;
-	}
+		m_decompressed.clear();
 
-	state.dsize_bits = static_cast<UInt32>(static_cast<UInt8>(*state.inputPtr++));
-
-	if (state.inputPtr >= state.inputEnd)
-	{
 		return;
 	}
 
-	state.bit_buff   = static_cast<UInt32>(static_cast<UInt8>(*state.inputPtr++));
+	state.type       = static_cast<UInt32>(static_cast<UInt8>(*state.inputPtr++));
 
-	state.extra_bits = 0U;
+	state.dsize_bits = static_cast<UInt32>(static_cast<UInt8>(*state.inputPtr++));
 
 
 	if (state.dsize_bits < 4U || state.dsize_bits > 6U)
@@ -350,227 +501,266 @@ Void ArxExplode::decompress()
 	}
 
 
-	state.dsize_mask = 0xFFFFU >> (0x10U - state.dsize_bits);
-
-
 	if (state.type != 0U && state.type != 1U)
 	{
 		m_logger.print<LogLevel::Error>("ArxExplode: Invalid compression mode.");
 	}
 
 
-	std::ranges::copy(Tables::LenBits, state.LenBits.begin());
+	OutputBuffer output{ m_decompressed.data(), m_decompressed.size(), &m_decompressed };
 
-	std::ranges::copy(Tables::ExLenBits, state.ExLenBits.begin());
+	if (m_intoOutput)
+	{
+		output = { m_output.data(), m_output.size(), nullptr };
+	}
 
-	std::ranges::copy(Tables::LenBase, state.LenBase.begin());
 
-	std::ranges::copy(Tables::DistBits, state.DistBits.begin());
+	const DecodeStatus status = DecodeStream(state, output, m_decompressedSize);
 
 
-	if (state.type == 1U)
+	if (!m_intoOutput)
 	{
-		std::ranges::copy(Tables::ChBitsAsc, state.ChBitsAsc.begin());
-
-		generateAsciiTables(state);
+		m_decompressed.resize(m_decompressedSize);
 	}
 
 
-	generateDecodeTables(state.LengthCodes,  Tables::LenCode,  Tables::LenBits);
-
-	generateDecodeTables(state.DistPosCodes, Tables::DistCode, Tables::DistBits);
-
+	if (status == DecodeStatus::Corrupt)
+	{
+		m_logger.print<LogLevel::Error>("ArxExplode: Decompression failed.");
+	}
 
-	auto& outVec = m_decompressed;
+	if (status == DecodeStatus::OutputFull)
+	{
+		m_logger.print<LogLevel::Error>("ArxExplode: Output buffer too small ({} bytes).", output.capacity);
+	}
+}
 
-	Size  outPos = 0ULL;
 
+ArxExplodeStream::ArxExplodeStream(Logger& logger) noexcept : m_logger{ logger }
+{
 
-	UInt32 nextLiteral;
+}
 
 
-	while (true)
+Size ArxExplodeStream::feed(std::span<const Byte> input)
+{
+	if (m_status == Status::Finished || m_status == Status::Corrupt)
 	{
-		nextLiteral = DecodeLit(state);
+		return 0ULL;
+	}
 
 
-		if (nextLiteral >= 0x305U)
-		{
-			break;
-		}
+	m_state.inputPtr = input.data();
 
+	m_state.inputEnd = input.data() + input.size();
 
-		if (nextLiteral < 0x100U)
-		{
-			const Byte b = static_cast<Byte>(nextLiteral);
 
+	// The two header bytes may arrive split across chunks
+	while (m_headerBytes < 2U && m_state.inputPtr < m_state.inputEnd)
+	{
+		const UInt32 value = static_cast<UInt32>(static_cast<UInt8>(*m_state.inputPtr++));
 
-			state.window[state.windowHead] = b;
+		if (m_headerBytes++ == 0U)
+		{
+			m_state.type = value;
 
-			state.windowHead = (state.windowHead + 1ULL) & State::WindowMask;
+			continue;
+		}
 
 
-			if (outPos == outVec.size()) [[unlikely]]
-			{
-				outVec.resize(outPos + 0x4000ULL);
-			}
+		m_state.dsize_bits = value;
 
-			outVec[outPos++] = b;
+		if (m_state.dsize_bits < 4U || m_state.dsize_bits > 6U)
+		{
+			fail("Invalid dictionary size.");
 		}
-		else
+		else if (m_state.type != 0U && m_state.type != 1U)
 		{
-			const UInt32 repLength = nextLiteral - 0xFEU;
-
-			const UInt32 minusDist = DecodeDist(state, repLength);
+			fail("Invalid compression mode.");
+		}
+	}
 
 
-			if (minusDist == 0U)
-			{
-				nextLiteral = 0x306U; // Error
+	if (m_headerBytes == 2U && m_status != Status::Corrupt)
+	{
+		decode();
+	}
 
-				break;
-			}
+	return static_cast<Size>(m_state.inputPtr - input.data());
+}
 
 
-			UInt32 sourceIdx = (static_cast<UInt32>(state.windowHead) - minusDist) & static_cast<UInt32>(State::WindowMask);
+Void ArxExplodeStream::finish()
+{
+	m_inputEnded = true;
 
+	if (m_status == Status::Finished || m_status == Status::Corrupt)
+	{
+		return;
+	}
 
-			if (outPos + repLength > outVec.size()) [[unlikely]]
-			{
-				outVec.resize(std::max(outVec.size() + 0x4000ULL, outPos + repLength));
-			}
 
+	if (m_headerBytes < 2U)
+	{
+		fail("Input ended inside the header.");
 
-			Byte* outPtr = outVec.data() + outPos;
+		return;
+	}
 
+	m_state.inputPtr = nullptr;
 
-			for (UInt32 i = 0; i < repLength; ++i)
-			{
-				const Byte b = state.window[sourceIdx];
+	m_state.inputEnd = nullptr;
 
-				sourceIdx = (sourceIdx + 1U) & static_cast<UInt32>(State::WindowMask);
+	decode();
+}
 
 
-				state.window[state.windowHead] = b;
+Size ArxExplodeStream::drain(std::span<Byte> output) noexcept
+{
+	const Size count = std::min(output.size(), m_writePos - m_readPos);
 
-				state.windowHead = (state.windowHead + 1ULL) & State::WindowMask; // говно
 
+	std::memcpy(output.data(), m_buffer.data() + m_readPos, count);
 
-				outPtr[i] = b;
-			}
+	m_readPos += count;
 
 
-			outPos += repLength;
-		}
-	}
+	return count;
+}
 
 
-	outVec.resize(outPos);
+Size ArxExplodeStream::getPendingSize() const noexcept
+{
+	return m_writePos - m_readPos;
+}
 
 
-	if (nextLiteral == 0x306U)
-	{
-		m_logger.print<LogLevel::Error>("ArxExplode: Decompression failed.");
-	}
+ArxExplodeStream::Status ArxExplodeStream::getStatus() const noexcept
+{
+	return m_status;
 }
 
 
-Void ArxExplode::generateDecodeTables(std::span<UInt8> positions, std::span<const UInt8> startIndexes, std::span<const UInt8> lengthBits)
+Bool ArxExplodeStream::isFinished() const noexcept
 {
-	const Size count = startIndexes.size();
+	return m_status == Status::Finished;
+}
 
 
-	for (Index i = 0; i < count; ++i)
+Void ArxExplodeStream::decode()
+{
+	while (true)
 	{
-		const Size  length = 1ULL << lengthBits[i];
+		if (!makeRoom())
+		{
+			m_status = Status::NeedOutput;
+
+			return;
+		}
+
+		Refill(m_state);
+
 
-		const UInt8 idx    = static_cast<UInt8>(i);
+		// Decode on a copy: a symbol cut off by the end of the chunk leaves the state untouched until more input arrives
+		ArxExplode::State trial = m_state;
 
-		const UInt8 start  = startIndexes[i];
+		const UInt32 nextLiteral = DecodeLit(trial);
 
 
-		for (Index index = start; index < 0x100ULL; index += length)
+		if (nextLiteral == 0x306U)
 		{
-			positions[index] = idx;
+			break;
 		}
-	}
-}
 
+		if (nextLiteral == 0x305U)
+		{
+			m_state  = trial;
 
-Void ArxExplode::generateAsciiTables(State& state)
-{
-	const UInt16* pChCodeAsc = &Tables::ChCodeAsc[0xFF];
+			m_status = Status::Finished;
 
+			return;
+		}
 
-	for (Int32 count = 0xFF; count >= 0; --pChCodeAsc, --count)
-	{
-		if (UInt8 bitsAsc = state.ChBitsAsc[count]; bitsAsc <= 8U)
+
+		if (nextLiteral < 0x100U)
 		{
-			const UInt32 add = (1U << bitsAsc);
+			m_buffer[m_writePos++] = static_cast<Byte>(nextLiteral);
 
-			      UInt32 acc = *pChCodeAsc;
+			m_state = trial;
 
-			do
-			{
-				state.Offs2C34[acc] = static_cast<UInt8>(count);
+			continue;
+		}
 
-				acc += add;
 
-			} while (acc < 0x100U);
+		const UInt32 repLength = nextLiteral - 0xFEU;
+
+		const UInt32 minusDist = DecodeDist(trial, repLength);
+
+
+		if (minusDist == 0U)
+		{
+			break;
 		}
-		else if (const UInt32 acc_tmp = (*pChCodeAsc & 0xFFU); acc_tmp != 0U)
+
+		if (minusDist > m_writePos)
 		{
-			state.Offs2C34[acc_tmp] = 0xFF;
+			fail("Decompression failed.");
 
+			return;
+		}
 
-			if (*pChCodeAsc & 0x3FU)
-			{
-				bitsAsc -= 4U;
 
-				const UInt32 add = (1U << bitsAsc);
+		CopyMatch(m_buffer.data() + m_writePos, minusDist, repLength);
 
-				      UInt32 acc = *pChCodeAsc >> 4U;
+		m_writePos += repLength;
 
-				do
-				{
-					state.Offs2D34[acc] = static_cast<UInt8>(count);
+		m_state = trial;
+	}
 
-					acc += add;
 
-				} while (acc < 0x100U);
-			}
-			else
-			{
-				bitsAsc -= 6U;
+	// Out of bits: more may come, unless finish() said otherwise
+	if (m_inputEnded)
+	{
+		fail("Input ended before the end-of-stream code.");
 
-				const UInt32 add = (1U << bitsAsc);
+		return;
+	}
 
-				      UInt32 acc = *pChCodeAsc >> 6U;
+	m_status = Status::NeedInput;
+}
 
-				do
-				{
-					state.Offs2E34[acc] = static_cast<UInt8>(count);
 
-					acc += add;
+Void ArxExplodeStream::fail(StringView reason)
+{
+	m_status = Status::Corrupt;
 
-				} while (acc < 0x80U);
-			}
-		}
-		else
-		{
-			bitsAsc -= 8U;
+	m_logger.print<LogLevel::Info>("ArxExplodeStream: {}", reason);
+}
 
-			const UInt32 add = (1U << bitsAsc);
 
-			      UInt32 acc = *pChCodeAsc >> 8U;
+Bool ArxExplodeStream::makeRoom() noexcept
+{
+	if (m_writePos + MaxMatchLength + MatchSlack <= BufferSize)
+	{
+		return true;
+	}
 
-			do
-			{
-				state.Offs2EB4[acc] = static_cast<UInt8>(count);
 
-				acc += add;
+	// Keep undrained bytes and the match history, discard everything older
+	const Size keepFrom = std::min<Size>(m_readPos, m_writePos > HistorySize ? m_writePos - HistorySize : 0ULL);
 
-			} while (acc < 0x100U);
-		}
+	if (keepFrom == 0ULL)
+	{
+		return false;
 	}
+
+
+	std::memmove(m_buffer.data(), m_buffer.data() + keepFrom, m_writePos - keepFrom);
+
+	m_readPos  -= keepFrom;
+
+	m_writePos -= keepFrom;
+
+
+	return m_writePos + MaxMatchLength + MatchSlack <= BufferSize;
 }
\ No newline at end of file
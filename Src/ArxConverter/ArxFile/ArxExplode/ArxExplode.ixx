@@ -19,86 +19,144 @@ public:
 
 	struct State final
 	{
-		static constexpr Size WindowSize = 0x2000ULL;
-
-		static constexpr Size WindowMask = WindowSize - 1ULL;
-
-
 		const Byte* inputPtr = nullptr;
 
 		const Byte* inputEnd = nullptr;
 
 
-		UInt32 bit_buff   = 0U;
+		UInt64 bit_buff  = 0ULL; ///< Bit accumulator, next unread bit is bit 0
 
-		UInt32 extra_bits = 0U;
+		UInt32 bit_count = 0U;   ///< Number of valid bits held in bit_buff
 
 
 		UInt32 type       = 0U;
 
 		UInt32 dsize_bits = 0U;
+	};
 
-		UInt32 dsize_mask = 0U;
 
+private:
 
-		Array<Byte, WindowSize> window{};
+	std::span<const Byte>    m_compressed;
 
-		Size windowHead = 0ULL;
+	UninitializedArray<Byte> m_decompressed;
 
 
-		Array<UInt8, 0x100> LengthCodes{};
+	std::span<Byte> m_output;             ///< Caller-provided destination, used instead of m_decompressed when m_intoOutput
 
-		Array<UInt8, 0x100> DistPosCodes{};
+	Bool            m_intoOutput = false;
 
+	Size            m_decompressedSize = 0ULL;
 
-		Array<UInt8, 0x100> Offs2C34{};
 
-		Array<UInt8, 0x100> Offs2D34{};
+	Logger& m_logger;
 
-		Array<UInt8, 0x100> Offs2E34{};
+public:
 
-		Array<UInt8, 0x100> Offs2EB4{};
+	ArxExplode() = delete;
 
-		Array<UInt8, 0x100> ChBitsAsc{};
+   ~ArxExplode() = default;
 
 
-		Array<UInt8, 0x40> DistBits{};
+	/// Decodes into an internal buffer that grows geometrically from a guess based on the compressed size
+	explicit ArxExplode(std::span<const Byte> compressed, Logger& logger);
 
-		Array<UInt8, 0x10> LenBits{};
+	/// Decodes into an internal buffer sized once from expectedSize (e.g. a PAK directory entry); grows only if the hint is short
+	explicit ArxExplode(std::span<const Byte> compressed, Size expectedSize, Logger& logger);
 
-		Array<UInt8, 0x10> ExLenBits{};
+	/// Decodes straight into a caller-provided buffer, never allocating; fails if the output does not fit
+	explicit ArxExplode(std::span<const Byte> compressed, std::span<Byte> output, Logger& logger);
 
-		Array<UInt16, 0x10> LenBase{};
-	};
+	/// Decodes into a buffer handed back from an earlier releaseDecompressed(), reusing its capacity (one per worker in a batch)
+	explicit ArxExplode(std::span<const Byte> compressed, UninitializedArray<Byte>&& recycled, Logger& logger);
+
+
+	[[nodiscard]] UninitializedArray<Byte> releaseDecompressed() noexcept;
+
+	[[nodiscard]] Size getDecompressedSize() const noexcept;
+
+
+private:
+
+	Void decompress();
+};
+
+
+/// Incremental ArxExplode decoder: feed compressed chunks as they arrive, drain decompressed chunks into caller buffers.
+/// Keeps only the bit reader and a small history buffer between calls, so neither stream has to be held in full.
+export class ArxExplodeStream final
+{
+public:
 
+	/// Why decoding last stopped
+	enum class Status : UInt8
+	{
+		NeedInput  = 0U, ///< A symbol is cut off: feed more bytes, or finish() when there are none
+		NeedOutput = 1U, ///< The internal buffer is full: drain, then feed again
+		Finished   = 2U, ///< The end-of-stream code was decoded
+		Corrupt    = 3U  ///< Invalid header or distance, or input ended before the end-of-stream code
+	};
 
 private:
 
-	const DynamicArray<Byte>& m_compressed;
+	static constexpr Size HistorySize = 0x1000ULL; ///< Longest match distance (4 KB dictionary)
+
+	static constexpr Size BufferSize  = 0x4000ULL; ///< History plus decoded bytes waiting to be drained
+
+
+	ArxExplode::State m_state;
+
+
+	Array<Byte, BufferSize> m_buffer;
+
+	Size m_readPos  = 0ULL;
+
+	Size m_writePos = 0ULL;
+
 
-	DynamicArray<Byte>        m_decompressed;
+	UInt32 m_headerBytes = 0U;
+
+	Status m_status      = Status::NeedInput;
+
+	Bool   m_inputEnded  = false;
 
 
 	Logger& m_logger;
 
 public:
 
-	ArxExplode() = delete;
+	ArxExplodeStream() = delete;
+
+   ~ArxExplodeStream() = default;
 
-   ~ArxExplode() = default;
 
+	explicit ArxExplodeStream(Logger& logger) noexcept;
 
-	explicit ArxExplode(const DynamicArray<Byte>& compressed, Logger& logger) noexcept;
 
+	/// Decodes from input until it runs out or the internal buffer is full and returns the number of bytes consumed.
+	/// Bytes not consumed must be fed again after draining; an empty span decodes what is already buffered.
+	[[nodiscard]] Size feed(std::span<const Byte> input);
 
-	[[nodiscard]] DynamicArray<Byte> releaseDecompressed() noexcept;
+	/// Declares that no more input will arrive and decodes what is still buffered. May be called again after draining
+	/// on NeedOutput; a stream that stops for lack of input from then on is Corrupt (truncated) instead of NeedInput
+	Void finish();
 
+	/// Moves decoded bytes into output and returns how many were written
+	[[nodiscard]] Size drain(std::span<Byte> output) noexcept;
+
+
+	[[nodiscard]] Size getPendingSize() const noexcept;
+
+	[[nodiscard]] Status getStatus() const noexcept;
+
+	/// True once the end-of-stream code has been decoded
+	[[nodiscard]] Bool isFinished() const noexcept;
 
 private:
 
-	Void decompress();
+	Void decode();
 
-	Void generateDecodeTables(std::span<UInt8> positions, std::span<const UInt8> startIndexes, std::span<const UInt8> lengthBits);
+	Void fail(StringView reason);
 
-	Void generateAsciiTables(State& state);
+	Bool makeRoom() noexcept;
 };
\ No newline at end of file
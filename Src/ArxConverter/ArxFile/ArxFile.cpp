@@ -1,5 +1,7 @@
 module;
 
+#include <span>
+#include <utility>
 #include <fstream>
 #include <filesystem>
 
@@ -7,23 +9,41 @@ module ArxConverter.ArxFile;
 
 
 import ArxConverter.ArxExplode;
+import ArxConverter.MappedFile;
 
 
-ArxFile::ArxFile(const String& inputFile, Logger& logger) noexcept : m_inputFile{ inputFile }, m_logger{ logger }
+ArxFile::ArxFile(const String& inputFile, Logger& logger) : ArxFile(inputFile, {}, logger)
 {
-	if (const auto rawData = read(); !rawData.empty())
+
+}
+
+
+ArxFile::ArxFile(const String& inputFile, UninitializedArray<Byte>&& recycled, Logger& logger) : m_inputFile{ inputFile }, m_logger{ logger }, m_decompressed{ std::move(recycled) }
+{
+	// Decompress straight from the page cache, the buffered read is only a fallback when mapping fails
+	if (const MappedFile mapped{ m_inputFile }; mapped.isOpen())
+    {
+        m_decompressed = decompress(mapped.getData());
+    }
+    else if (const auto rawData = read(); !rawData.empty())
     {
         m_decompressed = decompress(rawData);
     }
 }
 
 
-const DynamicArray<Byte>& ArxFile::getDecompressed() const noexcept
+std::span<const Byte> ArxFile::getDecompressed() const noexcept
 {
     return m_decompressed;
 }
 
 
+UninitializedArray<Byte> ArxFile::releaseDecompressed() noexcept
+{
+    return std::move(m_decompressed);
+}
+
+
 DynamicArray<Byte> ArxFile::read()
 {
 	std::ifstream file(m_inputFile, std::ios::binary | std::ios::ate);
@@ -61,9 +81,9 @@ DynamicArray<Byte> ArxFile::read()
     return buffer;
 }
 
-DynamicArray<Byte> ArxFile::decompress(const DynamicArray<Byte>& compressed)
+UninitializedArray<Byte> ArxFile::decompress(std::span<const Byte> compressed)
 {
-    ArxExplode exploder(compressed, m_logger);
+    ArxExplode exploder(compressed, std::move(m_decompressed), m_logger);
 
     return exploder.releaseDecompressed();
 }
\ No newline at end of file
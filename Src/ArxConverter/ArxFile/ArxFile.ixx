@@ -1,5 +1,7 @@
 module;
 
+#include <span>
+
 export module ArxConverter.ArxFile;
 
 
@@ -14,7 +16,7 @@ export class ArxFile final
 	Logger&       m_logger;
 
 
-	DynamicArray<Byte> m_decompressed;
+	UninitializedArray<Byte> m_decompressed;
 
 public:
 
@@ -23,14 +25,20 @@ public:
    ~ArxFile() = default;
 
 
-	explicit ArxFile(const String& inputFile, Logger& logger) noexcept;
+	explicit ArxFile(const String& inputFile, Logger& logger);
+
+	/// Decompresses into a recycled buffer, see releaseDecompressed()
+	explicit ArxFile(const String& inputFile, UninitializedArray<Byte>&& recycled, Logger& logger);
+
 
+	[[nodiscard]] std::span<const Byte> getDecompressed() const noexcept;
 
-	[[nodiscard]] const DynamicArray<Byte>& getDecompressed() const noexcept;
+	/// Hands the decompression buffer back so the next file can reuse its capacity
+	[[nodiscard]] UninitializedArray<Byte> releaseDecompressed() noexcept;
 
 private:
 
 	[[nodiscard]] DynamicArray<Byte> read();
 
-	[[nodiscard]] DynamicArray<Byte> decompress(const DynamicArray<Byte>& compressed);
+	[[nodiscard]] UninitializedArray<Byte> decompress(std::span<const Byte> compressed);
 };
\ No newline at end of file
@@ -0,0 +1,461 @@
+module;
+
+#include <span>
+#include <utility>
+#include <algorithm>
+
+module ArxConverter.ArxImplode;
+
+
+import ArxConverter.ArxTables;
+
+
+namespace Tables
+{
+	/// Complete bit pattern of one symbol, flag bit included, ready to be written LSB-first
+	struct EncodeEntry final
+	{
+		UInt32 code = 0U;
+
+		UInt32 bits = 0U;
+	};
+
+
+	/// Indexed by repetition length - 2; the last entry (0x205) is the end-of-stream code
+	constexpr auto LengthEncode = []
+	{
+		Array<EncodeEntry, 0x206> table{};
+
+		// LenBase and the extra bits are in the same length - 2 units as the index
+		for (Index index = 0; index < table.size(); ++index)
+		{
+			Index code = LenBase.size() - 1ULL;
+
+			while (LenBase[code] > index)
+			{
+				--code;
+			}
+
+
+			const UInt32 extra = static_cast<UInt32>(index - LenBase[code]);
+
+			table[index] =
+			{
+				1U | (static_cast<UInt32>(LenCode[code]) << 1U) | (extra << (1U + LenBits[code])),
+				1U + LenBits[code] + ExLenBits[code]
+			};
+		}
+
+		return table;
+	}();
+
+	/// Literal codes for ArxImplode::Mode::Ascii
+	constexpr auto AsciiEncode = []
+	{
+		Array<EncodeEntry, 0x100> table{};
+
+		for (Index literal = 0; literal < table.size(); ++literal)
+		{
+			table[literal] = { static_cast<UInt32>(ChCodeAsc[literal]) << 1U, 1U + ChBitsAsc[literal] };
+		}
+
+		return table;
+	}();
+
+	/// Literal codes for ArxImplode::Mode::Binary: flag bit followed by the raw byte
+	constexpr auto BinaryEncode = []
+	{
+		Array<EncodeEntry, 0x100> table{};
+
+		for (Index literal = 0; literal < table.size(); ++literal)
+		{
+			table[literal] = { static_cast<UInt32>(literal) << 1U, 9U };
+		}
+
+		return table;
+	}();
+}
+
+
+/// Shortest and longest repetitions the format can express
+constexpr Size MinMatchLength = 2ULL;
+
+constexpr Size MaxMatchLength = 0x206ULL;
+
+/// Two-byte repetitions only carry 2 low distance bits
+constexpr Size MaxShortDistance = 0x100ULL;
+
+/// Largest dictionary (4 KB), the chain ring covers any of them
+constexpr Size ChainSize = 0x1000ULL;
+
+constexpr Size ChainMask = ChainSize - 1ULL;
+
+constexpr UInt32 HashBits = 15U;
+
+
+struct Match final
+{
+	Size length   = 0ULL;
+
+	Size distance = 0ULL;
+};
+
+
+/// LSB-first bit packer matching ArxExplode's reader
+struct BitWriter final
+{
+	DynamicArray<Byte>& output;
+
+
+	UInt32 bit_buff  = 0U;
+
+	UInt32 bit_count = 0U;
+
+
+	Void put(UInt32 code, UInt32 nBits)
+	{
+		bit_buff  |= static_cast<UInt32>(code) << bit_count;
+
+		bit_count += nBits;
+
+
+		while (bit_count >= 8U)
+		{
+			output.push_back(static_cast<Byte>(bit_buff & 0xFFU));
+
+			bit_buff  >>= 8U;
+
+			bit_count  -= 8U;
+		}
+	}
+
+	Void flush()
+	{
+		if (bit_count != 0U)
+		{
+			output.push_back(static_cast<Byte>(bit_buff & 0xFFU));
+		}
+
+		bit_buff  = 0U;
+
+		bit_count = 0U;
+	}
+};
+
+
+/// Hash-chain match finder over 3-byte prefixes, with a direct 2-byte table for short repetitions
+class MatchFinder final
+{
+	/// Positions are stored as full Index values, so inputs past 2 GB cannot wrap and end a chain early
+	static constexpr Index NoPosition = ~Index{ 0 };
+
+
+	std::span<const Byte> m_data;
+
+
+	DynamicArray<Index> m_head;
+
+	DynamicArray<Index> m_headShort;
+
+	DynamicArray<Index> m_prev;
+
+
+	Size   m_maxDistance;
+
+	UInt32 m_maxChain;
+
+	Size   m_niceLength;
+
+public:
+
+	MatchFinder(std::span<const Byte> data, Size maxDistance, UInt32 maxChain, Size niceLength) :
+		m_data{ data }, m_head(1ULL << HashBits, NoPosition), m_headShort(0x10000ULL, NoPosition), m_prev(ChainSize, NoPosition),
+		m_maxDistance{ maxDistance }, m_maxChain{ maxChain }, m_niceLength{ niceLength }
+	{
+
+	}
+
+
+	Void insert(Size pos)
+	{
+		if (pos + 1ULL >= m_data.size())
+		{
+			return;
+		}
+
+		m_headShort[shortKey(pos)] = pos;
+
+
+		if (pos + 2ULL >= m_data.size())
+		{
+			return;
+		}
+
+		auto& head = m_head[hash(pos)];
+
+		m_prev[pos & ChainMask] = head;
+
+		head = pos;
+	}
+
+	/// Longest earlier repetition of the bytes at pos; must be called before pos is inserted
+	[[nodiscard]] Match find(Size pos) const
+	{
+		Match best;
+
+		const Size maxLength = std::min(MaxMatchLength, m_data.size() - pos);
+
+		if (maxLength < MinMatchLength)
+		{
+			return best;
+		}
+
+
+		if (maxLength >= 3ULL)
+		{
+			Index  candidate = m_head[hash(pos)];
+
+			UInt32 chain     = m_maxChain;
+
+
+			while (candidate != NoPosition && pos - candidate <= m_maxDistance && chain-- > 0U)
+			{
+				const Size from   = candidate;
+
+				const Size length = matchLength(from, pos, maxLength);
+
+
+				// Hash collisions can yield 2-byte hits here, but those need the short-distance table below
+				if (length >= 3ULL && length > best.length)
+				{
+					best = { length, pos - from };
+
+					if (length >= m_niceLength || length == maxLength)
+					{
+						break;
+					}
+				}
+
+
+				// Ring entries get reused, a non-decreasing link means the chain ran into newer data
+				const Index next = m_prev[from & ChainMask];
+
+				if (next == NoPosition || next >= candidate)
+				{
+					break;
+				}
+
+				candidate = next;
+			}
+		}
+
+
+		if (best.length < 3ULL)
+		{
+			if (const Index candidate = m_headShort[shortKey(pos)]; candidate != NoPosition && pos - candidate <= MaxShortDistance)
+			{
+				best = { MinMatchLength, pos - candidate };
+			}
+		}
+
+		return best;
+	}
+
+private:
+
+	[[nodiscard]] Size shortKey(Size pos) const
+	{
+		return static_cast<Size>(m_data[pos]) | (static_cast<Size>(m_data[pos + 1ULL]) << 8U);
+	}
+
+	[[nodiscard]] Size hash(Size pos) const
+	{
+		const UInt32 key = (static_cast<UInt32>(m_data[pos]) << 16U) | (static_cast<UInt32>(m_data[pos + 1ULL]) << 8U) | static_cast<UInt32>(m_data[pos + 2ULL]);
+
+		return (key * 2654435761U) >> (32U - HashBits);
+	}
+
+	[[nodiscard]] Size matchLength(Size from, Size pos, Size maxLength) const
+	{
+		Size length = 0ULL;
+
+		while (length < maxLength && m_data[from + length] == m_data[pos + length])
+		{
+			++length;
+		}
+
+		return length;
+	}
+};
+
+
+ArxImplode::ArxImplode(std::span<const Byte> input, Mode mode, Dictionary dictionary, UInt32 effort, Logger& logger) :
+	m_input{ input }, m_mode{ mode }, m_dictionary{ dictionary }, m_effort{ std::min(effort, MaxEffort) }, m_logger{ logger }
+{
+	compress();
+}
+
+
+DynamicArray<Byte> ArxImplode::releaseCompressed() noexcept
+{
+	return std::move(m_compressed);
+}
+
+
+Void ArxImplode::compress()
+{
+	const UInt32 dsizeBits = static_cast<UInt32>(m_dictionary);
+
+	if (dsizeBits < 4U || dsizeBits > 6U)
+	{
+		m_logger.print<LogLevel::Error>("ArxImplode: Invalid dictionary size.");
+	}
+
+
+	const auto& literals = (m_mode == Mode::Ascii) ? Tables::AsciiEncode : Tables::BinaryEncode;
+
+
+	// Worst case is all literals: up to 14 bits each in ASCII mode, plus the header and the end-of-stream code
+	m_compressed.clear();
+
+	m_compressed.reserve(2ULL + (m_input.size() * 14ULL + Tables::LengthEncode.back().bits + 7ULL) / 8ULL);
+
+	m_compressed.push_back(static_cast<Byte>(m_mode));
+
+	m_compressed.push_back(static_cast<Byte>(dsizeBits));
+
+
+	BitWriter writer{ m_compressed };
+
+
+	const Size dictionarySize = 0x40ULL << dsizeBits;
+
+	const Bool lazy           = m_effort >= 4U;
+
+	const Bool insertAll      = m_effort >= 2U;
+
+	MatchFinder finder{ m_input, dictionarySize, 1U << m_effort, std::min<Size>(8ULL << m_effort, MaxMatchLength) };
+
+
+	auto matchBits = [dsizeBits](const Match& match) -> UInt32
+	{
+		const Size   lowBits  = (match.length == MinMatchLength) ? 2U : dsizeBits;
+
+		const Size   position = (match.distance - 1ULL) >> lowBits;
+
+		return Tables::LengthEncode[match.length - MinMatchLength].bits + Tables::DistBits[position] + static_cast<UInt32>(lowBits);
+	};
+
+	// A repetition is only worth it when it is shorter than spelling its bytes out
+	auto worthwhile = [&](const Match& match, Size pos) -> Bool
+	{
+		if (match.length < MinMatchLength)
+		{
+			return false;
+		}
+
+		if (match.length >= 4ULL)
+		{
+			return true;
+		}
+
+
+		UInt32 literalBits = 0U;
+
+		for (Index i = 0; i < match.length; ++i)
+		{
+			literalBits += literals[static_cast<UInt8>(m_input[pos + i])].bits;
+		}
+
+		return matchBits(match) < literalBits;
+	};
+
+	auto emitMatch = [&](const Match& match)
+	{
+		const auto& [lengthCode, lengthBits] = Tables::LengthEncode[match.length - MinMatchLength];
+
+		writer.put(lengthCode, lengthBits);
+
+
+		const UInt32 lowBits  = (match.length == MinMatchLength) ? 2U : dsizeBits;
+
+		const UInt32 distance = static_cast<UInt32>(match.distance - 1ULL);
+
+		const UInt32 position = distance >> lowBits;
+
+
+		writer.put(Tables::DistCode[position], Tables::DistBits[position]);
+
+		writer.put(distance & ((1U << lowBits) - 1U), lowBits);
+	};
+
+
+	const Size size = m_input.size();
+
+	Size  pos   = 0ULL;
+
+	Match match = (size != 0ULL) ? finder.find(0ULL) : Match{};
+
+
+	while (pos < size)
+	{
+		finder.insert(pos);
+
+
+		if (!worthwhile(match, pos))
+		{
+			const auto& [code, bits] = literals[static_cast<UInt8>(m_input[pos])];
+
+			writer.put(code, bits);
+
+
+			++pos;
+
+			match = (pos < size) ? finder.find(pos) : Match{};
+
+			continue;
+		}
+
+
+		if (lazy && pos + 1ULL < size)
+		{
+			// Prefer a longer repetition starting one byte later
+			if (const Match next = finder.find(pos + 1ULL); next.length > match.length && worthwhile(next, pos + 1ULL))
+			{
+				const auto& [code, bits] = literals[static_cast<UInt8>(m_input[pos])];
+
+				writer.put(code, bits);
+
+
+				++pos;
+
+				match = next;
+
+				continue;
+			}
+		}
+
+
+		emitMatch(match);
+
+
+		if (insertAll)
+		{
+			for (Index i = 1; i < match.length; ++i)
+			{
+				finder.insert(pos + i);
+			}
+		}
+
+		pos += match.length;
+
+		match = (pos < size) ? finder.find(pos) : Match{};
+	}
+
+
+	const auto& [endCode, endBits] = Tables::LengthEncode.back();
+
+	writer.put(endCode, endBits);
+
+	writer.flush();
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+module;
+
+#include <span>
+
+export module ArxConverter.ArxImplode;
+
+
+import ArxConverter.Logger;
+
+import ArxConverter.Container;
+
+
+/// PKWARE DCL "implode" compressor producing streams ArxExplode can read
+export class ArxImplode final
+{
+public:
+
+	/// How literals are coded: raw 8-bit values, or the fixed ASCII Huffman code suited to text
+	enum class Mode : UInt8
+	{
+		Binary = 0U,
+		Ascii  = 1U
+	};
+
+	/// Sliding dictionary size, stored in the stream header as dsize_bits
+	enum class Dictionary : UInt8
+	{
+		Size1K = 4U,
+		Size2K = 5U,
+		Size4K = 6U
+	};
+
+
+	static constexpr UInt32 MinEffort     = 0U; ///< Greedy, first hash candidate only
+
+	static constexpr UInt32 MaxEffort     = 9U; ///< Long hash chains with lazy matching
+
+	static constexpr UInt32 DefaultEffort = 6U;
+
+private:
+
+	std::span<const Byte> m_input;
+
+	DynamicArray<Byte>    m_compressed;
+
+
+	Mode       m_mode;
+
+	Dictionary m_dictionary;
+
+	UInt32     m_effort;
+
+
+	Logger& m_logger;
+
+public:
+
+	ArxImplode() = delete;
+
+   ~ArxImplode() = default;
+
+
+	/// effort trades speed against ratio: it sets the hash chain depth and enables lazy matching from level 4
+	explicit ArxImplode(std::span<const Byte> input, Mode mode, Dictionary dictionary, UInt32 effort, Logger& logger);
+
+
+	[[nodiscard]] DynamicArray<Byte> releaseCompressed() noexcept;
+
+private:
+
+	Void compress();
+};
\ No newline at end of file
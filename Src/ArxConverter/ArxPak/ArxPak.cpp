@@ -0,0 +1,200 @@
+module;
+
+#include <span>
+#include <memory>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+
+module ArxConverter.ArxPak;
+
+
+import ArxConverter.ArxExplode;
+
+
+/// The directory is XOR-scrambled with one of these; its first 4 bytes are always zero in clear
+constexpr Array<std::string_view, 2> PakKeys =
+{
+	"AVQF3FCKE50GRIAYXJP2AMEYO5QGA0JGIIH2NHBTVOA1VOGGU5H3GSSIARKPRQPHHTURZAXAHHHHBBWCGPFSDGDSBSDB", // Full game
+	"NSIARKPRQPHBTE"                                                                                  // Demo
+};
+
+/// Entry flag set when the data is PKWARE DCL imploded
+constexpr UInt32 PakFileCompressed = 1U;
+
+
+Bool ReadU32(std::span<const Byte> data, Size& pos, UInt32& value)
+{
+	if (data.size() - pos < sizeof(UInt32))
+	{
+		return false;
+	}
+
+	std::memcpy(&value, data.data() + pos, sizeof(UInt32));
+
+	pos += sizeof(UInt32);
+
+	return true;
+}
+
+Bool ReadString(std::span<const Byte> data, Size& pos, String& value)
+{
+	const auto begin = data.begin() + static_cast<std::ptrdiff_t>(pos);
+
+	const auto end   = std::find(begin, data.end(), Byte{ 0 });
+
+	if (end == data.end())
+	{
+		return false;
+	}
+
+	value.assign(reinterpret_cast<const Char8*>(std::to_address(begin)), static_cast<Size>(end - begin));
+
+	std::ranges::replace(value, '\\', '/');
+
+	pos += value.size() + 1ULL;
+
+	return true;
+}
+
+
+ArxPak::ArxPak(const String& inputFile, Logger& logger) : m_inputFile{ inputFile }, m_logger{ logger }, m_archive{ inputFile }
+{
+	if (!m_archive.isOpen())
+	{
+		m_logger.print<LogLevel::Error>("Couldn't open archive: \"{}\"", m_inputFile);
+	}
+
+	readDirectory();
+}
+
+
+std::span<const ArxPak::Entry> ArxPak::getEntries() const noexcept
+{
+	return m_entries;
+}
+
+
+std::span<const Byte> ArxPak::getStored(const Entry& entry) const noexcept
+{
+	return m_archive.getData().subspan(entry.offset, entry.size);
+}
+
+
+UninitializedArray<Byte> ArxPak::extract(const Entry& entry) const
+{
+	const auto stored = getStored(entry);
+
+	if (!entry.compressed)
+	{
+		return { stored.begin(), stored.end() };
+	}
+
+
+	ArxExplode exploder(stored, entry.uncompressedSize, m_logger);
+
+	if (exploder.getDecompressedSize() != entry.uncompressedSize)
+	{
+		m_logger.print<LogLevel::Error>("Size mismatch in archive entry: \"{}\"", entry.path);
+	}
+
+	return exploder.releaseDecompressed();
+}
+
+
+Void ArxPak::readDirectory()
+{
+	const auto archive = m_archive.getData();
+
+	Size   pos             = 0ULL;
+
+	UInt32 directoryOffset = 0U;
+
+	UInt32 directorySize   = 0U;
+
+	if (!ReadU32(archive, pos, directoryOffset) || directoryOffset > archive.size())
+	{
+		m_logger.print<LogLevel::Error>("Invalid archive header: \"{}\"", m_inputFile);
+	}
+
+	pos = directoryOffset;
+
+	if (!ReadU32(archive, pos, directorySize) || directorySize > archive.size() - pos)
+	{
+		m_logger.print<LogLevel::Error>("Invalid archive directory: \"{}\"", m_inputFile);
+	}
+
+
+	const auto scrambled = archive.subspan(pos, directorySize);
+
+	DynamicArray<Byte> directory(scrambled.begin(), scrambled.end());
+
+	// The cleartext root directory record starts with zeros, so the first bytes give the key away
+	for (const auto key : PakKeys)
+	{
+		if (directory.size() >= 4ULL && std::memcmp(directory.data(), key.data(), 4ULL) == 0)
+		{
+			for (Index i = 0; i < directory.size(); ++i)
+			{
+				directory[i] ^= static_cast<Byte>(key[i % key.size()]);
+			}
+
+			break;
+		}
+	}
+
+
+	if (!parseDirectory(directory))
+	{
+		m_logger.print<LogLevel::Error>("Corrupt archive directory: \"{}\"", m_inputFile);
+	}
+}
+
+
+Bool ArxPak::parseDirectory(std::span<const Byte> directory)
+{
+	const Size archiveSize = m_archive.getData().size();
+
+	Size   pos = 0ULL;
+
+	String directoryName;
+
+	String fileName;
+
+	while (pos < directory.size())
+	{
+		UInt32 fileCount = 0U;
+
+		if (!ReadString(directory, pos, directoryName) || !ReadU32(directory, pos, fileCount))
+		{
+			return false;
+		}
+
+		if (!directoryName.empty() && directoryName.back() != '/')
+		{
+			directoryName += '/';
+		}
+
+
+		for (UInt32 i = 0U; i < fileCount; ++i)
+		{
+			UInt32 offset = 0U, flags = 0U, uncompressedSize = 0U, size = 0U;
+
+			if (!ReadString(directory, pos, fileName) || !ReadU32(directory, pos, offset) || !ReadU32(directory, pos, flags) ||
+				!ReadU32(directory, pos, uncompressedSize) || !ReadU32(directory, pos, size))
+			{
+				return false;
+			}
+
+			if (offset > archiveSize || size > archiveSize - offset)
+			{
+				return false;
+			}
+
+			m_entries.push_back({ directoryName + fileName, offset, size, uncompressedSize, (flags & PakFileCompressed) != 0U });
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+module;
+
+#include <span>
+
+export module ArxConverter.ArxPak;
+
+
+import ArxConverter.Logger;
+import ArxConverter.Container;
+import ArxConverter.MappedFile;
+
+
+/// Arx Fatalis .pak archive: a memory-mapped body plus a directory of imploded (or stored) entries
+export class ArxPak final
+{
+public:
+
+	struct Entry final
+	{
+		String path;             ///< Full path inside the archive, '/' separated
+
+		Size   offset = 0ULL;
+
+		Size   size   = 0ULL;    ///< Bytes stored in the archive
+
+		Size   uncompressedSize = 0ULL;
+
+		Bool   compressed = false;
+	};
+
+private:
+
+	const String& m_inputFile;
+
+	Logger&       m_logger;
+
+
+	MappedFile          m_archive;
+
+	DynamicArray<Entry> m_entries;
+
+public:
+
+	ArxPak() = delete;
+
+   ~ArxPak() = default;
+
+
+	explicit ArxPak(const String& inputFile, Logger& logger);
+
+
+	[[nodiscard]] std::span<const Entry> getEntries() const noexcept;
+
+	/// Bytes of the entry as stored in the mapped archive, still imploded when entry.compressed
+	[[nodiscard]] std::span<const Byte> getStored(const Entry& entry) const noexcept;
+
+	/// Decompresses one entry straight from the mapped archive, sized from its directory record
+	[[nodiscard]] UninitializedArray<Byte> extract(const Entry& entry) const;
+
+private:
+
+	Void readDirectory();
+
+	[[nodiscard]] Bool parseDirectory(std::span<const Byte> directory);
+};
\ No newline at end of file
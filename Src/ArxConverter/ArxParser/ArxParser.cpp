@@ -1,5 +1,6 @@
 module;
 
+#include <span>
 #include <cstring>
 #include <string_view>
 
@@ -18,7 +19,7 @@ const Type* ArxParser::mapRaw(Size offset) const
 }
 
 
-ArxParser::ArxParser(const DynamicArray<Byte>& data, Logger& logger) noexcept : m_data{ data }, m_logger{ logger }
+ArxParser::ArxParser(std::span<const Byte> data, Logger& logger) : m_data{ data }, m_logger{ logger }
 {
     parse();
 }
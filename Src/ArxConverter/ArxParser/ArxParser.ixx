@@ -12,7 +12,7 @@ import ArxConverter.ArxHeaders;
 
 export class ArxParser final
 {
-	const DynamicArray<Byte>& m_data;
+	std::span<const Byte> m_data;
 
 
 	Logger& m_logger;
@@ -29,7 +29,7 @@ public:
    ~ArxParser() = default;
 
 
-	explicit ArxParser(const DynamicArray<Byte>& data, Logger& logger) noexcept;
+	explicit ArxParser(std::span<const Byte> data, Logger& logger);
 
 
 	[[nodiscard]] const FtlHeaders&  getHeaders() const noexcept;
@@ -3,6 +3,8 @@ module;
 #include <array>
 #include <memory>
 #include <vector>
+#include <utility>
+#include <type_traits>
 
 export module ArxConverter.Container;
 
@@ -10,12 +12,47 @@ export module ArxConverter.Container;
 export import ArxConverter.Types;
 
 
+/// Allocator that default-initializes elements, so resize() leaves trivial types uninitialized instead of zero-filling
+template<typename Type>
+struct DefaultInitAllocator : std::allocator<Type>
+{
+	template<typename Other>
+	struct rebind final
+	{
+		using other = DefaultInitAllocator<Other>;
+	};
+
+
+	DefaultInitAllocator() noexcept = default;
+
+	template<typename Other>
+	DefaultInitAllocator(const DefaultInitAllocator<Other>&) noexcept {}
+
+
+	template<typename Other>
+	Void construct(Other* ptr) noexcept(std::is_nothrow_default_constructible_v<Other>)
+	{
+		::new(static_cast<Void*>(ptr)) Other;
+	}
+
+	template<typename Other, typename... Args>
+	Void construct(Other* ptr, Args&&... args)
+	{
+		::new(static_cast<Void*>(ptr)) Other(std::forward<Args>(args)...);
+	}
+};
+
+
 export template<typename Type, Count count>
 using Array = std::array<Type, count>;
 
 export template<typename Type>
 using DynamicArray = std::vector<Type>;
 
+/// DynamicArray whose resize() does not initialize new trivial elements (large byte buffers that are overwritten anyway)
+export template<typename Type>
+using UninitializedArray = std::vector<Type, DefaultInitAllocator<Type>>;
+
 
 export template<typename Type>
 using Unique = std::unique_ptr<Type>;
\ No newline at end of file
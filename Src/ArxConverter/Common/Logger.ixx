@@ -1,6 +1,8 @@
 module;
 
+#include <mutex>
 #include <cstdlib>
+#include <stdexcept>
 #include "fmt/color.h"
 
 #ifdef _WIN32
@@ -33,6 +35,9 @@ export class Logger final
        { "ERROR", { 0xE1, 0xB4, 0xB4 } }
     }};
 
+    /// Keeps lines from parallel workers whole
+    mutable std::mutex m_mutex;
+
 public:
 
     Logger();
@@ -99,11 +104,15 @@ Void Logger::print(fmt::format_string<Args...> format, Args&&... args) const
     const auto& [ label, color ] = m_preset.at(static_cast<Index>(level));
 
 
-    fmt::print(fmt::fg(color), "[{}] {}\n", label, message);
+    {
+        const std::scoped_lock lock{ m_mutex };
+
+        fmt::print(fmt::fg(color), "[{}] {}\n", label, message);
+    }
 
 
     if constexpr (level == Level::Error)
     {
-       throw;
+       throw std::runtime_error(message);
     }
 }
\ No newline at end of file
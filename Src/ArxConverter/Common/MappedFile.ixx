@@ -0,0 +1,145 @@
+module;
+
+#include <span>
+
+#ifdef _WIN32
+
+#include "Windows.h"
+
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#endif
+
+export module ArxConverter.MappedFile;
+
+
+import ArxConverter.Container;
+
+
+/// Read-only view of a whole file mapped into memory, unmapped on destruction
+export class MappedFile final
+{
+    const Byte* m_data = nullptr;
+
+    Size        m_size = 0ULL;
+
+public:
+
+    MappedFile() = delete;
+
+   ~MappedFile();
+
+
+    /// Leaves the view empty when the file can't be mapped (missing, empty, not a regular file)
+    explicit MappedFile(const String& path) noexcept;
+
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+
+    [[nodiscard]] Bool isOpen() const noexcept;
+
+    [[nodiscard]] std::span<const Byte> getData() const noexcept;
+};
+
+
+MappedFile::MappedFile(const String& path) noexcept
+{
+    #ifdef _WIN32
+
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER size{};
+
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        // The view keeps the mapping alive, both handles can go right away
+        if (const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0UL, 0UL, nullptr); mapping != nullptr)
+        {
+            if (const Void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0UL, 0UL, 0ULL); view != nullptr)
+            {
+                m_data = static_cast<const Byte*>(view);
+
+                m_size = static_cast<Size>(size.QuadPart);
+            }
+
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+
+    #else
+
+    const Int32 file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat info{};
+
+    if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        const Size size = static_cast<Size>(info.st_size);
+
+        // The mapping holds its own reference to the file, the descriptor can go right away
+        if (Void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0); view != MAP_FAILED)
+        {
+            // The whole file is consumed front to back exactly once
+            madvise(view, size, MADV_SEQUENTIAL);
+
+            m_data = static_cast<const Byte*>(view);
+
+            m_size = size;
+        }
+    }
+
+    close(file);
+
+    #endif
+}
+
+
+MappedFile::~MappedFile()
+{
+    if (m_data == nullptr)
+    {
+        return;
+    }
+
+    #ifdef _WIN32
+
+    UnmapViewOfFile(m_data);
+
+    #else
+
+    munmap(const_cast<Byte*>(m_data), m_size);
+
+    #endif
+}
+
+
+Bool MappedFile::isOpen() const noexcept
+{
+    return m_data != nullptr;
+}
+
+
+std::span<const Byte> MappedFile::getData() const noexcept
+{
+    return { m_data, m_size };
+}
\ No newline at end of file
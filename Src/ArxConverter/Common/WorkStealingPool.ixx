@@ -0,0 +1,185 @@
+module;
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+export module ArxConverter.WorkStealingPool;
+
+
+import ArxConverter.Container;
+
+
+/// Runs a fixed set of independent tasks on N threads. Each worker drains its own queue front to back
+/// and, once empty, steals the earliest task left in the others', so a few expensive tasks can't leave cores idle
+export class WorkStealingPool final
+{
+    struct Queue final
+    {
+        std::mutex        mutex;
+
+        std::deque<Index> tasks;
+    };
+
+
+    Size m_workerCount;
+
+public:
+
+    WorkStealingPool() = delete;
+
+   ~WorkStealingPool() = default;
+
+
+    /// workerCount == 0 picks one worker per hardware thread
+    explicit WorkStealingPool(Size workerCount) noexcept;
+
+
+    [[nodiscard]] Size getWorkerCount() const noexcept;
+
+    /// Calls task(taskIndex, workerIndex) once for every index in [0, taskCount) and returns when all are done.
+    /// Tasks are dealt round-robin in index order, put the expensive ones first. task must not throw
+    template<typename Task>
+    Void run(Size taskCount, Task&& task);
+
+private:
+
+    [[nodiscard]] static Bool pop(Queue& queue, Index& taskIndex);
+
+    [[nodiscard]] static Bool peek(Queue& queue, Index& taskIndex);
+};
+
+
+WorkStealingPool::WorkStealingPool(Size workerCount) noexcept : m_workerCount{ workerCount }
+{
+    if (m_workerCount == 0ULL)
+    {
+        m_workerCount = std::max<Size>(std::thread::hardware_concurrency(), 1ULL);
+    }
+}
+
+
+Size WorkStealingPool::getWorkerCount() const noexcept
+{
+    return m_workerCount;
+}
+
+
+template<typename Task>
+Void WorkStealingPool::run(Size taskCount, Task&& task)
+{
+    const Size workers = std::min(m_workerCount, taskCount);
+
+    if (workers <= 1ULL)
+    {
+        for (Index i = 0; i < taskCount; ++i)
+        {
+            task(i, 0ULL);
+        }
+
+        return;
+    }
+
+
+    DynamicArray<Queue> queues(workers);
+
+    for (Index i = 0; i < taskCount; ++i)
+    {
+        queues[i % workers].tasks.push_back(i);
+    }
+
+
+    // Callers order tasks most expensive first, so the front of every queue holds its costliest task. Thieves
+    // take the front of the queue whose front is the earliest index, which behaves like one shared largest-first
+    // queue; stealing from the back (Chase-Lev style) would grab the cheapest leftovers while a big model waits to
+    // run last. The tasks are independent files, so the locality LIFO stealing buys does not apply here.
+    // No task spawns new ones, so a worker that finds every queue empty is done for good
+    auto work = [&](Index worker)
+    {
+        Index taskIndex = 0ULL;
+
+        while (true)
+        {
+            Bool found = pop(queues[worker], taskIndex);
+
+            while (!found)
+            {
+                Index victim   = workers;
+
+                Index earliest = 0ULL;
+
+                for (Index offset = 1ULL; offset < workers; ++offset)
+                {
+                    const Index other = (worker + offset) % workers;
+
+                    if (Index front = 0ULL; peek(queues[other], front) && (victim == workers || front < earliest))
+                    {
+                        victim   = other;
+
+                        earliest = front;
+                    }
+                }
+
+                if (victim == workers)
+                {
+                    return;
+                }
+
+                // Another thief may have emptied the victim since the peek, then look again
+                found = pop(queues[victim], taskIndex);
+            }
+
+            task(taskIndex, worker);
+        }
+    };
+
+
+    {
+        DynamicArray<std::jthread> threads;
+
+        threads.reserve(workers - 1ULL);
+
+        for (Index worker = 1ULL; worker < workers; ++worker)
+        {
+            threads.emplace_back(work, worker);
+        }
+
+        work(0ULL);
+    }
+}
+
+
+Bool WorkStealingPool::pop(Queue& queue, Index& taskIndex)
+{
+    const std::scoped_lock lock{ queue.mutex };
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+
+    taskIndex = queue.tasks.front();
+
+    queue.tasks.pop_front();
+
+    return true;
+}
+
+
+Bool WorkStealingPool::peek(Queue& queue, Index& taskIndex)
+{
+    const std::scoped_lock lock{ queue.mutex };
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+
+    taskIndex = queue.tasks.front();
+
+    return true;
+}
\ No newline at end of file